@@ -17,177 +17,226 @@
 
 #include "RACM600.h"
 
-RACM600::RACM600(uint8_t i2c_address) {
-    _address = i2c_address;
-}
-
-void RACM600::begin() {
-    Wire.begin();
-}
-
-// Generic Read Function
-uint16_t RACM600::readCommand(uint8_t cmd) {
-    Wire.beginTransmission(_address);
-    Wire.write(cmd);
-    Wire.endTransmission(false);
-    
-    Wire.requestFrom(_address, (uint8_t)2);
-    if (Wire.available() >= 2) {
-        uint8_t low = Wire.read();
-        uint8_t high = Wire.read();
-        return (high << 8) | low;
+// Registers captured by readSnapshot(), in RACM600SnapshotChannel order
+const uint8_t RACM600Base::SNAPSHOT_COMMANDS[RACM600_SNAPSHOT_CHANNELS] = {
+    RACM600_READ_VOUT,
+    RACM600_READ_IOUT,
+    RACM600_READ_TEMPERATURE_1,
+    RACM600_READ_TEMPERATURE_2,
+    RACM600_READ_TEMPERATURE_3,
+    RACM600_READ_POUT,
+    RACM600_READ_VIN,
+    RACM600_READ_VCAP,
+    RACM600_STATUS_WORD
+};
+
+// Registers captured by readAuxSnapshot() from Page 1, in RACM600AuxChannel order
+const uint8_t RACM600Base::AUX_SNAPSHOT_COMMANDS[RACM600_AUX_CHANNELS] = {
+    RACM600_READ_VOUT,
+    RACM600_READ_IOUT,
+    RACM600_READ_TEMPERATURE_3,
+    RACM600_READ_POUT
+};
+
+// Rating registers read by readRatings(), in RACM600Rating order
+const uint8_t RACM600Base::RATING_COMMANDS[RACM600_RATINGS] = {
+    RACM600_MFR_VIN_MIN,
+    RACM600_MFR_VIN_MAX,
+    RACM600_MFR_IIN_MAX,
+    RACM600_MFR_PIN_MAX,
+    RACM600_MFR_VOUT_MIN,
+    RACM600_MFR_VOUT_MAX,
+    RACM600_MFR_IOUT_MAX,
+    RACM600_MFR_POUT_MAX,
+    RACM600_MFR_TAMBIENT_MAX,
+    RACM600_MFR_TAMBIENT_MIN
+};
+
+// Writable limits, in RACM600Limit order
+const uint8_t RACM600Base::LIMIT_COMMANDS[RACM600_LIMITS] = {
+    RACM600_VOUT_OV_FAULT_LIMIT,
+    RACM600_IOUT_OC_FAULT_LIMIT,
+    RACM600_IOUT_OC_WARN_LIMIT
+};
+
+// Encodes a limit in mV or mA, VOUT_OV_FAULT_LIMIT as LINEAR16 with voutMode and the others as LINEAR11
+uint16_t RACM600Base::encodeLimit(uint8_t limit, int32_t value, uint8_t voutMode) {
+    if (limit == RACM600_LIMIT_VOUT_OV_FAULT) {
+        return RACM600Linear::encodeLinear16Scaled(value, voutMode, 1000);
     }
-    return 0;
+    return RACM600Linear::encodeLinear11Scaled(value, 1000);
 }
 
-// Generic Write Function
-void RACM600::writeCommand(uint8_t cmd, uint16_t value) {
-    Wire.beginTransmission(_address);
-    Wire.write(cmd);
-    Wire.write(lowByte(value));
-    Wire.write(highByte(value));
-    Wire.endTransmission();
-}
-
-// Enable Power Output
-void RACM600::enableOutput() {
-    Wire.beginTransmission(_address);
-    Wire.write(RACM600_OPERATION);  // OPERATION Command
-    Wire.write(0x80);  // Bit 7: ON
-    Wire.endTransmission();
-}
-
-// Disable Power Output
-void RACM600::disableOutput() {
-    Wire.beginTransmission(_address);
-    Wire.write(RACM600_OPERATION);  // OPERATION Command
-    Wire.write(0x00);  // Bit 7: OFF
-    Wire.endTransmission();
-}
-
-// Clear Faults
-void RACM600::clearFaults() {
-    Wire.beginTransmission(_address);
-    Wire.write(RACM600_CLEAR_FAULTS); // CLEAR_FAULTS Command
-    Wire.endTransmission();
-}
-
-// Read Output Voltage
-float RACM600::readVoltage() {
-    uint16_t raw = readCommand(RACM600_READ_VOUT);  // READ_VOUT Command
-    return raw * 0.01;  // Scale factor for Volts
-}
-
-// Read Output Current
-float RACM600::readCurrent() {
-    uint16_t raw = readCommand(RACM600_READ_IOUT);  // READ_IOUT Command
-    return raw * 0.01;  // Scale factor for Amperes
-}
-
-// Read Temperature of the air around the power supply
-float RACM600::readAmbientTemperature() {
-    uint16_t raw = readCommand(RACM600_READ_TEMPERATURE_1);  // READ_TEMPERATURE_1 Command
-    return raw;  // Already in °C
+int32_t RACM600Base::decodeLimit(uint8_t limit, uint16_t raw, uint8_t voutMode) {
+    if (limit == RACM600_LIMIT_VOUT_OV_FAULT) {
+        return RACM600Linear::decodeLinear16Scaled(raw, voutMode, 1000);
+    }
+    return RACM600Linear::decodeLinear11Scaled(raw, 1000);
 }
 
-// Read Temperature of the power factor correction circuit
-float RACM600::readACINPUTTemperature() {
-    uint16_t raw = readCommand(RACM600_READ_TEMPERATURE_2);  // READ_TEMPERATURE_2 Command
-    return raw;  // Already in °C
+// With maximum in [2^(bits-1), 2^bits), a shift of bits + 21 puts 2^shift * 1000 / maximum
+// between 2^21 * 1000 and 2^22 * 1000, just under 2^31 and 2^32, so it always fits 32 bits
+RACM600Reciprocal RACM600Reciprocal::forMaximum(int32_t maximum) {
+    RACM600Reciprocal reciprocal = { 0, 0 };
+    if (maximum <= 0) {
+        return reciprocal;
+    }
+    uint8_t bits = 0;
+    while (bits < 31 && ((uint32_t)maximum >> bits) != 0) {
+        bits++;
+    }
+    reciprocal.shift = bits + 21;
+    reciprocal.multiplier = (uint32_t)((((uint64_t)1000 << reciprocal.shift) + maximum / 2) / maximum);
+    return reciprocal;
 }
 
-// Read Temperature of the LLC resonant converter stage
-float RACM600::readDCOUTPUTTemperature() {
-    uint16_t raw = readCommand(RACM600_READ_TEMPERATURE_3);  // READ_TEMPERATURE_3 Command
-    return raw;  // Already in °C
+// Decodes raw MFR_* words, VOUT ratings are LINEAR16 with voutMode, every other one LINEAR11
+void RACM600Base::decodeRatings(const uint16_t raw[RACM600_RATINGS], uint8_t voutMode, Ratings& ratings) {
+    ratings.vinMin_mV = RACM600Linear::decodeLinear11Scaled(raw[RACM600_RATING_VIN_MIN], 1000);
+    ratings.vinMax_mV = RACM600Linear::decodeLinear11Scaled(raw[RACM600_RATING_VIN_MAX], 1000);
+    ratings.iinMax_mA = RACM600Linear::decodeLinear11Scaled(raw[RACM600_RATING_IIN_MAX], 1000);
+    ratings.pinMax_mW = RACM600Linear::decodeLinear11Scaled(raw[RACM600_RATING_PIN_MAX], 1000);
+    ratings.voutMin_mV = RACM600Linear::decodeLinear16Scaled(raw[RACM600_RATING_VOUT_MIN], voutMode, 1000);
+    ratings.voutMax_mV = RACM600Linear::decodeLinear16Scaled(raw[RACM600_RATING_VOUT_MAX], voutMode, 1000);
+    ratings.ioutMax_mA = RACM600Linear::decodeLinear11Scaled(raw[RACM600_RATING_IOUT_MAX], 1000);
+    ratings.poutMax_mW = RACM600Linear::decodeLinear11Scaled(raw[RACM600_RATING_POUT_MAX], 1000);
+    ratings.tambientMax_cC = RACM600Linear::decodeLinear11Scaled(raw[RACM600_RATING_TAMBIENT_MAX], 100);
+    ratings.tambientMin_cC = RACM600Linear::decodeLinear11Scaled(raw[RACM600_RATING_TAMBIENT_MIN], 100);
+
+    ratings.iinReciprocal = RACM600Reciprocal::forMaximum(ratings.iinMax_mA);
+    ratings.pinReciprocal = RACM600Reciprocal::forMaximum(ratings.pinMax_mW);
+    ratings.ioutReciprocal = RACM600Reciprocal::forMaximum(ratings.ioutMax_mA);
+    ratings.poutReciprocal = RACM600Reciprocal::forMaximum(ratings.poutMax_mW);
 }
 
-// Read basic faults from the fault register, and calls readDetailedFault as needed
-uint16_t RACM600::readFaults() {
-    uint16_t status = readCommand(RACM600_STATUS_WORD);
-    
-    Serial.print("Fault Status: 0x");
-    Serial.println(status, HEX);
-
-    if (status == 0) {
-        Serial.println("No faults detected.");
-        return status;
-    }
-
-    // Check each fault and print messages
-    if (status & 0x0080) Serial.println("FAULT: Device Busy");
-    if (status & 0x0040) Serial.println("FAULT: Power Output Off");
-    if (status & 0x0020) {
-        Serial.println("FAULT: Output Overvoltage");
-        readDetailedFault(RACM600_STATUS_VOUT, "Output Voltage Fault");
-    }
-    if (status & 0x0010) {
-        Serial.println("FAULT: Output Overcurrent");
-        readDetailedFault(RACM600_STATUS_IOUT, "Output Current Fault");
-    }
-    if (status & 0x0008) {
-        Serial.println("FAULT: Input Undervoltage");
-        readDetailedFault(RACM600_STATUS_INPUT, "Input Fault");
-    }
-    if (status & 0x0004) {
-        Serial.println("FAULT: Temperature Fault");
-        readDetailedFault(RACM600_STATUS_TEMPERATURE, "Temperature Fault");
-    }
-    if (status & 0x0002) {
-        Serial.println("FAULT: Communication Fault (CML)");
-        readDetailedFault(RACM600_STATUS_CML, "Communication Fault");
+// True for registers with one instance per output, which PAGE selects between
+bool RACM600Base::isPaged(uint8_t cmd) {
+    switch (cmd) {
+        case RACM600_OPERATION:
+        case RACM600_VOUT_MODE:
+        case RACM600_VOUT_OV_FAULT_LIMIT:
+        case RACM600_IOUT_OC_FAULT_LIMIT:
+        case RACM600_IOUT_OC_WARN_LIMIT:
+        case RACM600_READ_VOUT:
+        case RACM600_READ_IOUT:
+        case RACM600_READ_TEMPERATURE_3:
+        case RACM600_READ_POUT:
+        case RACM600_STATUS_WORD:
+        case RACM600_STATUS_BYTE:
+        case RACM600_STATUS_VOUT:
+        case RACM600_STATUS_IOUT:
+            return true;
+        default:
+            return false;
     }
-    if (status & 0x0001) Serial.println("FAULT: Unknown Fault");
-
-    // Warnings
-    if (status & 0x8000) Serial.println("WARNING: Output Voltage Issue");
-    if (status & 0x4000) Serial.println("WARNING: Output Current or Power Issue");
-    if (status & 0x2000) Serial.println("WARNING: Input Voltage or Power Issue");
-    if (status & 0x1000) Serial.println("WARNING: Manufacturer-Specific Issue");
-    if (status & 0x0800) Serial.println("WARNING: Power Good Signal Lost");
-    if (status & 0x0200) Serial.println("WARNING: Fan or Airflow Issue");
-    if (status & 0x0100) Serial.println("WARNING: Other Status Warning");
-
-    return status;
 }
 
-
-// Reads the detailed fault register so we can figure out exactly what fault is occuring.
-void RACM600::readDetailedFault(uint8_t faultRegister, const char* faultType) {
-    uint8_t faultStatus = readCommand(faultRegister);
-
-    Serial.print(faultType);
-    Serial.print(" Details: 0x");
-    Serial.println(faultStatus, HEX);
-
-    if (faultRegister == RACM600_STATUS_VOUT) {
-        if (faultStatus & 0x80) Serial.println(" - Output Overvoltage Fault");
-        if (faultStatus & 0x40) Serial.println(" - Output Overvoltage Warning");
-        if (faultStatus & 0x10) Serial.println(" - Output Undervoltage Warning");
-        if (faultStatus & 0x08) Serial.println(" - Output Undervoltage Fault");
+// Meaning of a single status bit, used by printFaults()
+struct RACM600FaultBit {
+    uint8_t reg;                // STATUS_WORD or the detail register holding the bit
+    uint16_t mask;
+    const char* description;
+};
+
+static constexpr RACM600FaultBit RACM600_FAULT_BITS[] = {
+    // STATUS_WORD faults
+    { RACM600_STATUS_WORD, 0x0080, "FAULT: Device Busy" },
+    { RACM600_STATUS_WORD, 0x0040, "FAULT: Power Output Off" },
+    { RACM600_STATUS_WORD, 0x0020, "FAULT: Output Overvoltage" },
+    { RACM600_STATUS_WORD, 0x0010, "FAULT: Output Overcurrent" },
+    { RACM600_STATUS_WORD, 0x0008, "FAULT: Input Undervoltage" },
+    { RACM600_STATUS_WORD, 0x0004, "FAULT: Temperature Fault" },
+    { RACM600_STATUS_WORD, 0x0002, "FAULT: Communication Fault (CML)" },
+    { RACM600_STATUS_WORD, 0x0001, "FAULT: Unknown Fault" },
+
+    // STATUS_WORD warnings
+    { RACM600_STATUS_WORD, 0x8000, "WARNING: Output Voltage Issue" },
+    { RACM600_STATUS_WORD, 0x4000, "WARNING: Output Current or Power Issue" },
+    { RACM600_STATUS_WORD, 0x2000, "WARNING: Input Voltage or Power Issue" },
+    { RACM600_STATUS_WORD, 0x1000, "WARNING: Manufacturer-Specific Issue" },
+    { RACM600_STATUS_WORD, 0x0800, "WARNING: Power Good Signal Lost" },
+    { RACM600_STATUS_WORD, 0x0200, "WARNING: Fan or Airflow Issue" },
+    { RACM600_STATUS_WORD, 0x0100, "WARNING: Other Status Warning" },
+
+    // Detail registers
+    { RACM600_STATUS_VOUT, 0x80, " - Output Overvoltage Fault" },
+    { RACM600_STATUS_VOUT, 0x40, " - Output Overvoltage Warning" },
+    { RACM600_STATUS_VOUT, 0x10, " - Output Undervoltage Warning" },
+    { RACM600_STATUS_VOUT, 0x08, " - Output Undervoltage Fault" },
+    { RACM600_STATUS_IOUT, 0x80, " - Output Overcurrent Fault" },
+    { RACM600_STATUS_IOUT, 0x40, " - Critical Constant Current Mode Fault" },
+    { RACM600_STATUS_IOUT, 0x20, " - Output Overcurrent Warning" },
+    { RACM600_STATUS_INPUT, 0x80, " - Input Overvoltage Fault" },
+    { RACM600_STATUS_INPUT, 0x40, " - Input Overvoltage Warning" },
+    { RACM600_STATUS_INPUT, 0x10, " - Input Undervoltage Warning" },
+    { RACM600_STATUS_INPUT, 0x08, " - Input Undervoltage Fault" },
+    { RACM600_STATUS_TEMPERATURE, 0x80, " - Overtemperature Fault" },
+    { RACM600_STATUS_TEMPERATURE, 0x40, " - Overtemperature Warning" },
+    { RACM600_STATUS_CML, 0x80, " - Invalid Command Received" },
+    { RACM600_STATUS_CML, 0x40, " - Invalid Data Received" },
+    { RACM600_STATUS_CML, 0x20, " - Packet Error Check Failed" }
+};
+
+// Detail register read for each STATUS_WORD summary bit, in RACM600FaultDetail order
+const RACM600FaultDetailRegister RACM600Base::FAULT_DETAIL_REGISTERS[RACM600_FAULT_DETAILS] = {
+    { 0x0020, RACM600_STATUS_VOUT,        "Output Voltage Fault" },
+    { 0x0010, RACM600_STATUS_IOUT,        "Output Current Fault" },
+    { 0x0008, RACM600_STATUS_INPUT,       "Input Fault" },
+    { 0x0004, RACM600_STATUS_TEMPERATURE, "Temperature Fault" },
+    { 0x0002, RACM600_STATUS_CML,         "Communication Fault" }
+};
+
+// Expands to the compile time scale of 4, 16 and 32 consecutive exponent fields
+#define RACM600_SCALE_4(f)  RACM600Linear::fieldScale(f), RACM600Linear::fieldScale(f + 1), \
+                            RACM600Linear::fieldScale(f + 2), RACM600Linear::fieldScale(f + 3)
+#define RACM600_SCALE_16(f) RACM600_SCALE_4(f), RACM600_SCALE_4(f + 4), RACM600_SCALE_4(f + 8), RACM600_SCALE_4(f + 12)
+
+const float RACM600_LINEAR_SCALE[32] PROGMEM = { RACM600_SCALE_16(0), RACM600_SCALE_16(16) };
+
+#ifndef RACM600_PEC_BITWISE
+// Expands to the compile time CRC-8 of 4, 16, 64 and 256 consecutive byte values
+#define RACM600_CRC8_4(v)   RACM600Pec::entry(v), RACM600Pec::entry(v + 1), RACM600Pec::entry(v + 2), RACM600Pec::entry(v + 3)
+#define RACM600_CRC8_16(v)  RACM600_CRC8_4(v), RACM600_CRC8_4(v + 4), RACM600_CRC8_4(v + 8), RACM600_CRC8_4(v + 12)
+#define RACM600_CRC8_64(v)  RACM600_CRC8_16(v), RACM600_CRC8_16(v + 16), RACM600_CRC8_16(v + 32), RACM600_CRC8_16(v + 48)
+
+const uint8_t RACM600_CRC8_TABLE[256] PROGMEM = {
+    RACM600_CRC8_64(0), RACM600_CRC8_64(64), RACM600_CRC8_64(128), RACM600_CRC8_64(192)
+};
+#endif
+
+#ifdef ARDUINO
+// Prints every description in the bit table that is set in value for the given register
+static void printFaultBits(uint8_t reg, uint16_t value, Print& out) {
+    for (uint8_t i = 0; i < sizeof(RACM600_FAULT_BITS) / sizeof(RACM600_FAULT_BITS[0]); i++) {
+        if (RACM600_FAULT_BITS[i].reg == reg && (value & RACM600_FAULT_BITS[i].mask)) {
+            out.println(RACM600_FAULT_BITS[i].description);
+        }
     }
+}
 
-    if (faultRegister == RACM600_STATUS_IOUT) {
-        if (faultStatus & 0x80) Serial.println(" - Output Overcurrent Fault");
-        if (faultStatus & 0x40) Serial.println(" - Critical Constant Current Mode Fault");
-        if (faultStatus & 0x20) Serial.println(" - Output Overcurrent Warning");
-    }
+// Prints a fault report from the bit description table, kept apart from the bus reads
+void RACM600Base::printFaults(const FaultReport& report, Print& out) {
+    out.print("Fault Status: 0x");
+    out.println(report.statusWord, HEX);
 
-    if (faultRegister == RACM600_STATUS_INPUT) {
-        if (faultStatus & 0x80) Serial.println(" - Input Overvoltage Fault");
-        if (faultStatus & 0x40) Serial.println(" - Input Overvoltage Warning");
-        if (faultStatus & 0x10) Serial.println(" - Input Undervoltage Warning");
-        if (faultStatus & 0x08) Serial.println(" - Input Undervoltage Fault");
+    if (report.statusWord == 0) {
+        out.println("No faults detected.");
+        return;
     }
-
-    if (faultRegister == RACM600_STATUS_TEMPERATURE) {
-        if (faultStatus & 0x80) Serial.println(" - Overtemperature Fault");
-        if (faultStatus & 0x40) Serial.println(" - Overtemperature Warning");
+    printFaultBits(RACM600_STATUS_WORD, report.statusWord, out);
+
+    // Detail registers, only for the summary bits that caused them to be read
+    for (uint8_t i = 0; i < RACM600_FAULT_DETAILS; i++) {
+        const RACM600FaultDetailRegister& detail = FAULT_DETAIL_REGISTERS[i];
+        if (report.statusWord & detail.summaryMask) {
+            out.print(detail.name);
+            out.print(" Details: 0x");
+            out.println(report.detail[i], HEX);
+            printFaultBits(detail.cmd, report.detail[i], out);
+        }
     }
+}
 
-    if (faultRegister == RACM600_STATUS_CML) {
-        if (faultStatus & 0x80) Serial.println(" - Invalid Command Received");
-        if (faultStatus & 0x40) Serial.println(" - Invalid Data Received");
-        if (faultStatus & 0x20) Serial.println(" - Packet Error Check Failed");
-    }
-}
\ No newline at end of file
+// The Wire driver behind RACM600, declared extern in RACM600.h
+template class RACM600Device<RACM600WireBus>;
+#endif
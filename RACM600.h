@@ -19,10 +19,30 @@
 #ifndef RACM600_H
 #define RACM600_H
 
-#include <Arduino.h>
-#include <Wire.h>
+#include "RACM600Platform.h"
+#include "RACM600Linear.h"
+#include "RACM600Pec.h"
+#include "RACM600Stats.h"
+
+#ifdef ARDUINO
+#include "RACM600WireBus.h"
+#include "RACM600Alert.h"
+#endif
 
 #define RACM600_DEFAULT_ADDR  0x27 // Default I2C address
+#define RACM600_ALERT_RESPONSE_ADDR 0x0C // SMBus Alert Response Address
+
+#define RACM600_PAGE_MAIN           0       // Page 0: Main output
+#define RACM600_PAGE_AUX            1       // Page 1: AUX / VSB output
+#define RACM600_PAGE_UNKNOWN        0xFF    // PAGE shadow before the first PAGE write, or after a failed one
+
+#ifndef RACM600_MAX_BACKOFF_MICROS
+#define RACM600_MAX_BACKOFF_MICROS 20000  // Longest single wait between read retries
+#endif
+
+#ifndef RACM600_MAX_DATA_LENGTH
+#define RACM600_MAX_DATA_LENGTH 4   // Largest data payload of a single read or write, in bytes
+#endif
 
 // PMBus Commands for RACM600
 #define RACM600_PAGE                    0x00  // R/W, 1 Byte - Selects power output page (Page 0: Main, Page 1: AUX)
@@ -68,30 +88,406 @@
 #define RACM600_MFR_TAMBIENT_MIN        0xA9  // R-Word, 2 Bytes - Minimum rated ambient temperature in Celsius
 
 
+// Channel order of a telemetry snapshot, matches the register list read by readSnapshot()
+enum RACM600SnapshotChannel {
+    RACM600_CH_VOUT = 0,        // READ_VOUT
+    RACM600_CH_IOUT,            // READ_IOUT
+    RACM600_CH_TEMPERATURE_1,   // READ_TEMPERATURE_1 (Ambient)
+    RACM600_CH_TEMPERATURE_2,   // READ_TEMPERATURE_2 (PFC)
+    RACM600_CH_TEMPERATURE_3,   // READ_TEMPERATURE_3 (LLC)
+    RACM600_CH_POUT,            // READ_POUT
+    RACM600_CH_VIN,             // READ_VIN
+    RACM600_CH_VCAP,            // READ_VCAP
+    RACM600_CH_STATUS_WORD,     // STATUS_WORD
+    RACM600_SNAPSHOT_CHANNELS
+};
+
+// Raw register values captured back to back in a single pass
+struct RACM600Snapshot {
+    uint32_t timestamp;                         // micros() at the start of the capture
+    uint8_t voutMode;                           // Cached VOUT_MODE the VOUT channel is encoded with
+    uint16_t raw[RACM600_SNAPSHOT_CHANNELS];    // Raw register words, indexed by RACM600SnapshotChannel
+} __attribute__((packed));
+
+// Channel order of an AUX (Page 1) snapshot, matches the register list read by readAuxSnapshot()
+enum RACM600AuxChannel {
+    RACM600_AUX_VOUT = 0,       // READ_VOUT
+    RACM600_AUX_IOUT,           // READ_IOUT
+    RACM600_AUX_TEMPERATURE_3,  // READ_TEMPERATURE_3 (VSB)
+    RACM600_AUX_POUT,           // READ_POUT
+    RACM600_AUX_CHANNELS
+};
+
+// Raw Page 1 register values captured back to back in a single pass
+struct RACM600AuxSnapshot {
+    uint32_t timestamp;                         // micros() at the start of the capture
+    uint8_t voutMode;                           // Cached Page 1 VOUT_MODE the VOUT channel is encoded with
+    uint16_t raw[RACM600_AUX_CHANNELS];         // Raw register words, indexed by RACM600AuxChannel
+} __attribute__((packed));
+
+// Detail status registers captured in a fault report, in STATUS_VOUT..STATUS_CML order
+enum RACM600FaultDetail {
+    RACM600_DETAIL_VOUT = 0,    // STATUS_VOUT
+    RACM600_DETAIL_IOUT,        // STATUS_IOUT
+    RACM600_DETAIL_INPUT,       // STATUS_INPUT
+    RACM600_DETAIL_TEMPERATURE, // STATUS_TEMPERATURE
+    RACM600_DETAIL_CML,         // STATUS_CML
+    RACM600_FAULT_DETAILS
+};
+
+// STATUS_WORD plus the detail registers its summary bits pointed at, 0 where not flagged
+struct RACM600FaultReport {
+    uint16_t statusWord;
+    uint16_t changed;                           // STATUS_WORD bits that set or cleared since the previous readFaults()
+    uint8_t detail[RACM600_FAULT_DETAILS];      // Indexed by RACM600FaultDetail
+};
+
+
+// Detail register read for each STATUS_WORD summary bit, in RACM600FaultDetail order
+struct RACM600FaultDetailRegister {
+    uint16_t summaryMask;
+    uint8_t cmd;
+    const char* name;
+};
+
+// MFR_* rating registers in command order, MFR_VIN_MIN..MFR_TAMBIENT_MIN
+enum RACM600Rating {
+    RACM600_RATING_VIN_MIN = 0,
+    RACM600_RATING_VIN_MAX,
+    RACM600_RATING_IIN_MAX,
+    RACM600_RATING_PIN_MAX,
+    RACM600_RATING_VOUT_MIN,
+    RACM600_RATING_VOUT_MAX,
+    RACM600_RATING_IOUT_MAX,
+    RACM600_RATING_POUT_MAX,
+    RACM600_RATING_TAMBIENT_MAX,
+    RACM600_RATING_TAMBIENT_MIN,
+    RACM600_RATINGS
+};
+
+// Most registers read in one batch
+#define RACM600_MAX_BATCH ((int)RACM600_RATINGS > (int)RACM600_SNAPSHOT_CHANNELS ? (int)RACM600_RATINGS : (int)RACM600_SNAPSHOT_CHANNELS)
+
+// 1000 / maximum as a 32 bit multiplier and a shift, normalized so the multiplier uses 31 to
+// 32 bits. value * 1000 / maximum is then a multiply and a shift, correctly rounded for any
+// value up to 2^31 and exactly 1000 at the maximum.
+struct RACM600Reciprocal {
+    uint32_t multiplier;                        // 2^shift * 1000 / maximum, 0 when the maximum is not positive
+    uint8_t shift;
+
+    static RACM600Reciprocal forMaximum(int32_t maximum);
+
+    int32_t perMille(int32_t value) const {
+        return (int32_t)(((int64_t)value * multiplier + (((int64_t)1 << shift) >> 1)) >> shift);
+    }
+};
+
+// Manufacturer ratings decoded to integers, with reciprocals of the maxima so loading
+// can be expressed per mille of the rating with a multiply and a shift, no division
+struct RACM600Ratings {
+    int32_t vinMin_mV;
+    int32_t vinMax_mV;
+    int32_t iinMax_mA;
+    int32_t pinMax_mW;
+    int32_t voutMin_mV;
+    int32_t voutMax_mV;
+    int32_t ioutMax_mA;
+    int32_t poutMax_mW;
+    int32_t tambientMax_cC;                     // Hundredths of a degree Celsius
+    int32_t tambientMin_cC;
+
+    RACM600Reciprocal iinReciprocal;
+    RACM600Reciprocal pinReciprocal;
+    RACM600Reciprocal ioutReciprocal;
+    RACM600Reciprocal poutReciprocal;
+
+    int32_t iinPerMille(int32_t milliamps) const { return iinReciprocal.perMille(milliamps); }
+    int32_t pinPerMille(int32_t milliwatts) const { return pinReciprocal.perMille(milliwatts); }
+    int32_t ioutPerMille(int32_t milliamps) const { return ioutReciprocal.perMille(milliamps); }
+    int32_t poutPerMille(int32_t milliwatts) const { return poutReciprocal.perMille(milliwatts); }
+};
+
+// Writable limits, one set per page
+enum RACM600Limit {
+    RACM600_LIMIT_VOUT_OV_FAULT = 0,            // VOUT_OV_FAULT_LIMIT, LINEAR16, mV
+    RACM600_LIMIT_IOUT_OC_FAULT,                // IOUT_OC_FAULT_LIMIT, LINEAR11, mA
+    RACM600_LIMIT_IOUT_OC_WARN,                 // IOUT_OC_WARN_LIMIT, LINEAR11, mA
+    RACM600_LIMITS
+};
+
+// Every writable limit of one page, for setLimits() and readLimits()
+struct RACM600Limits {
+    int32_t voutOvFault_mV;
+    int32_t ioutOcFault_mA;
+    int32_t ioutOcWarn_mA;
+};
+
+// Outcome of a status-returning read or a verified write
+enum RACM600Status {
+    RACM600_OK = 0,
+    RACM600_BUS_ERROR,          // NAK, or fewer bytes arrived than requested
+    RACM600_PEC_ERROR,          // Data arrived but its PEC did not match
+    RACM600_INVALID,            // Refused without touching the bus, e.g. an unknown sensor
+    RACM600_VERIFY_ERROR        // A write was acknowledged but reading it back gave another value
+};
+
+
+class RACM600WireBus;
 
-class RACM600 {
+/*
+ * Bus independent parts of the driver, shared by every RACM600Device instantiation
+ * and implemented once in RACM600.cpp.
+ */
+class RACM600Base {
+public:
+    typedef RACM600Snapshot Snapshot;
+    typedef RACM600FaultReport FaultReport;
+    typedef RACM600AuxSnapshot AuxSnapshot;
+    typedef RACM600Ratings Ratings;
+    typedef RACM600Limits Limits;
+
+    static bool isPaged(uint8_t cmd);
+    static void decodeRatings(const uint16_t raw[RACM600_RATINGS], uint8_t voutMode, Ratings& ratings);
+    static uint16_t encodeLimit(uint8_t limit, int32_t value, uint8_t voutMode);
+    static int32_t decodeLimit(uint8_t limit, uint16_t raw, uint8_t voutMode);
+
+#ifdef ARDUINO
+    static void printFaults(const FaultReport& report, Print& out = Serial);
+#endif
+
+protected:
+    static const uint8_t SNAPSHOT_COMMANDS[RACM600_SNAPSHOT_CHANNELS];
+    static const uint8_t AUX_SNAPSHOT_COMMANDS[RACM600_AUX_CHANNELS];
+    static const uint8_t RATING_COMMANDS[RACM600_RATINGS];
+    static const uint8_t LIMIT_COMMANDS[RACM600_LIMITS];
+    static const RACM600FaultDetailRegister FAULT_DETAIL_REGISTERS[RACM600_FAULT_DETAILS];
+};
+
+
+/*
+ * RACM600 driver over any transport satisfying the bus concept described in
+ * RACM600WireBus.h. The bus is a template parameter, so every transfer is a direct,
+ * inlinable call. RACM600 is this class over the Arduino Wire bus.
+ */
+template <class Bus = RACM600WireBus>
+class RACM600Device : public RACM600Base {
 public:
-    RACM600(uint8_t i2c_address = RACM600_DEFAULT_ADDR);
+    RACM600Device(uint8_t i2c_address = RACM600_DEFAULT_ADDR, const Bus& bus = Bus());
     void begin();
     
     // Command Functions
     void enableOutput();
     void disableOutput();
     void clearFaults();
+
+    // PMBus Group Command: one transaction with a repeated start per supply and a single STOP,
+    // so every supply executes the command at the same moment
+    static bool groupWrite(RACM600Device* const devices[], uint8_t count, uint8_t cmd, const uint8_t* data, uint8_t length);
+    static bool groupWriteCommand(RACM600Device* const devices[], uint8_t count, uint8_t cmd, uint16_t value);
+    static bool groupEnableOutput(RACM600Device* const devices[], uint8_t count);
+    static bool groupDisableOutput(RACM600Device* const devices[], uint8_t count);
+
+    // Sets the limits of page on every device: PAGE is selected per device where a limit changes,
+    // each limit goes to every device that needs it in one Group Command, then each device reads
+    // back what it was sent in one batch. Returns the number of devices holding the limits, verified.
+    static uint8_t groupSetLimits(RACM600Device* const devices[], uint8_t count, const Limits& limits, uint8_t page = RACM600_PAGE_MAIN);
+
     uint16_t readFaults();
+    uint16_t readFaults(FaultReport& report);
+    RACM600Status tryReadFaults(FaultReport& report);
+    void resetFaultCache();
+    uint16_t checkHealth(FaultReport& report);
+    uint8_t lastHealthCheckBytes() const;
+    uint32_t wireBytes() const;
+#ifdef ARDUINO
+    bool serviceAlert(FaultReport& report);
+    static RACM600Device* serviceAlert(RACM600Device* const devices[], uint8_t count, FaultReport& report);
+#endif
+    uint8_t readAlertResponse();
+    uint8_t address() const;
+    Bus& bus();
     float readVoltage();
     float readCurrent();
     float readAmbientTemperature();
     float readACINPUTTemperature();
     float readDCOUTPUTTemperature();
+    float readPower();
+
+    // Integer Readers, decoded with shifts and integer multiplies only (no soft-float)
+    int32_t readVoltage_mV();
+    int32_t readCurrent_mA();
+    int32_t readAmbientTemperature_cC();
+    int32_t readACINPUTTemperature_cC();
+    int32_t readDCOUTPUTTemperature_cC();
+    int32_t readPower_mW();
+
+    // Status-returning Readers. The readers above return 0 when the bus fails; these leave the
+    // value untouched and report why instead. Failed reads are retried per setRetryPolicy().
+    RACM600Status tryReadWord(uint8_t cmd, uint16_t& raw);
+    RACM600Status tryReadByte(uint8_t cmd, uint8_t& raw);
+    RACM600Status tryReadWord(uint8_t cmd, uint8_t page, uint16_t& raw);
+    RACM600Status tryReadByte(uint8_t cmd, uint8_t page, uint8_t& raw);
+    RACM600Status tryReadVoltage(float& volts);
+    RACM600Status tryReadCurrent(float& amps);
+    RACM600Status tryReadTemperature(uint8_t sensor, float& celsius);
+    RACM600Status tryReadVoltage_mV(int32_t& millivolts);
+    RACM600Status tryReadCurrent_mA(int32_t& milliamps);
+    RACM600Status tryReadPower(float& watts);
+    RACM600Status tryReadPower_mW(int32_t& milliwatts);
+    RACM600Status lastStatus() const;
+
+    // Retry Policy, per instance. A failed read is retried up to retries times, waiting
+    // backoffMicros before the first retry and doubling the wait before each next one,
+    // up to RACM600_MAX_BACKOFF_MICROS. Registers that fail in a batched read (snapshots,
+    // ratings, limit read-back) are retried one by one the same way. Writes are never retried.
+    // Off (0 retries) by default.
+    void setRetryPolicy(uint8_t retries, uint16_t backoffMicros);
+    uint8_t retryLimit() const;
+    uint16_t retryBackoff() const;
+    uint32_t retries() const;
+
+    // Packet Error Checking, off by default. When on, every transaction carries a CRC-8
+    // and reads whose PEC does not match fail instead of returning corrupted data.
+    void setPec(bool enabled);
+    bool pecEnabled() const;
+    uint32_t pecErrors() const;
+
+    // Telemetry Functions
+    bool readSnapshot(Snapshot& snapshot);
+    bool readAuxSnapshot(AuxSnapshot& snapshot);
+    bool readSnapshot(Snapshot& snapshot, AuxSnapshot& aux);
+
+    // Manufacturer ratings, read in one batch on first use and cached for the lifetime of
+    // the object. begin() does not read them, sketches that never ask pay nothing.
+    const Ratings& ratings();
+    bool readRatings();
+    bool ratingsValid() const;
+
+    // Limit Setters. Values are encoded in the register's LINEAR format and written only when
+    // they differ from the shadow of what the device holds; the registers written are then read
+    // back in one batch, and RACM600_VERIFY_ERROR is returned if one does not match.
+    // Values the format cannot hold exactly are rounded to the nearest one it can.
+    RACM600Status setVoutOvFaultLimit_mV(int32_t millivolts, uint8_t page = RACM600_PAGE_MAIN);
+    RACM600Status setIoutOcFaultLimit_mA(int32_t milliamps, uint8_t page = RACM600_PAGE_MAIN);
+    RACM600Status setIoutOcWarnLimit_mA(int32_t milliamps, uint8_t page = RACM600_PAGE_MAIN);
+    RACM600Status setLimits(const Limits& limits, uint8_t page = RACM600_PAGE_MAIN);
+    RACM600Status readLimits(Limits& limits, uint8_t page = RACM600_PAGE_MAIN);
+    void invalidateLimits();
+    uint32_t limitWrites() const;
+
+    // PAGE selects the Main (0) or AUX/VSB (1) output for paged registers (see isPaged()).
+    // The selected page is shadowed, PAGE is only written when a read needs the other page.
+    // Readers without a page argument always read Page 0.
+    bool setPage(uint8_t page);
+    uint8_t page() const;
+    void invalidatePage();
+    uint32_t pageWrites() const;
+
+    // VOUT_MODE is read once per page and cached, READ_VOUT is decoded with its exponent.
+    // Call refreshVoutMode() after anything that may change it.
+    bool refreshVoutMode(uint8_t page = RACM600_PAGE_MAIN);
+    uint8_t voutMode(uint8_t page = RACM600_PAGE_MAIN) const;
+
+    // Non-blocking Read Functions
+    // beginRead() queues a word read, each poll() call then performs one I2C phase
+    // (command write, then the repeated-start read) and returns true once the result
+    // is ready. The bus is held between phases, so other traffic on it must wait.
+    bool beginRead(uint8_t cmd);
+    bool poll();
+    bool resultReady() const;
+    bool readResult(uint16_t& value);
+    uint32_t lastTransactionMicros() const;
+    uint32_t maxPollStepMicros() const;
+    void resetPollTiming();
     
 private:
+    // Phases of the non-blocking read engine
+    enum PollState {
+        POLL_IDLE,
+        POLL_WRITE,
+        POLL_READ,
+        POLL_READY
+    };
+
+    Bus _bus;
     uint8_t _address;
+    bool _pec;
+    uint32_t _pecErrors;
+
+    // Retry policy and the outcome of the last read
+    uint8_t _retryLimit;
+    uint16_t _retryBackoff;
+    uint32_t _retries;
+    RACM600Status _lastStatus;
+
+    // Cached MFR_* ratings
+    Ratings _ratings;
+    bool _ratingsValid;
+
+    // Shadows of the limits of each page as decoded values, bit page * RACM600_LIMITS + limit
+    // of _limitsKnown is set while the shadow matches the device
+    int32_t _limits[2][RACM600_LIMITS];
+    uint8_t _limitsKnown;
+    uint8_t _limitsPending;     // Limits groupSetLimits() has yet to send to this device
+    uint32_t _limitWrites;
+
+    // Shadow of the device's PAGE register
+    uint8_t _page;
+    uint32_t _pageWrites;
+
+    // Cached VOUT_MODE and the LINEAR16 scale derived from its exponent, Page 0 and Page 1
+    uint8_t _voutMode;
+    bool _voutModeValid;
+    float _voutScale;
+    uint8_t _auxVoutMode;
+    bool _auxVoutModeValid;
+
+    // Last fault report, detail registers are only re-read when their summary bit changes
+    FaultReport _faults;
+    bool _faultsValid;
+    uint16_t _faultsUnread;     // Summary bits whose detail register failed to read, retried next time
+
+    // Bus traffic accounting, in bytes on the wire including address bytes
+    uint32_t _wireBytes;
+    uint8_t _lastHealthCheckBytes;
+
+    // Non-blocking read state
+    PollState _pollState;
+    uint8_t _pollCommand;
+    bool _pollSucceeded;
+    uint8_t _pollData[3];
+    uint32_t _pollStart;
+    uint32_t _pollLatency;
+    uint32_t _pollMaxStep;
 
     // Helper Functions
-    void writeCommand(uint8_t cmd, uint16_t value);
+    bool writeCommand(uint8_t cmd, uint16_t value);
     uint16_t readCommand(uint8_t cmd);
-    void readDetailedFault(uint8_t faultRegister, const char* faultType);
+    RACM600Status readBytes(uint8_t cmd, uint8_t* data, uint8_t length, uint8_t page = RACM600_PAGE_MAIN);
+    bool readBatch(const uint8_t* commands, uint8_t count, uint16_t* raw);
+    RACM600Status writeLimits(const int32_t* values, uint8_t mask, uint8_t page);
+    uint8_t staleLimits(const int32_t* values, uint8_t mask, uint8_t page) const;
+    void markLimitWritten(uint8_t limit, uint8_t page);
+    RACM600Status verifyLimits(const int32_t* values, uint8_t mask, uint8_t page);
+    bool ensureVoutMode(uint8_t page);
+    bool voutModeValid(uint8_t page) const;
+    RACM600Status readAttempt(uint8_t cmd, uint8_t* data, uint8_t length);
+    RACM600Status retryRead(uint8_t cmd, uint8_t* data, uint8_t length, RACM600Status status);
+    bool writeBytes(uint8_t cmd, const uint8_t* data, uint8_t length, bool stop = true);
+    uint8_t readPec(uint8_t cmd, const uint8_t* data, uint8_t length) const;
+    uint8_t writePec(uint8_t cmd, const uint8_t* data, uint8_t length) const;
+    uint32_t statsMicros();
+    void statsRecord(uint8_t cmd, uint32_t micros, uint8_t bytes, bool ok);
 };
 
+#include "RACM600Impl.h"
+
+#ifdef ARDUINO
+// The Wire instantiation is compiled once, in RACM600.cpp
+extern template class RACM600Device<RACM600WireBus>;
+
+// RACM600 on the global Wire bus, `RACM600 psu;` talks to 0x27 over Wire
+typedef RACM600Device<RACM600WireBus> RACM600;
+#endif
+
 #endif
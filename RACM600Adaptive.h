@@ -0,0 +1,233 @@
+/**
+ *   @file RACM600Adaptive.h
+ *
+ *  Adaptive telemetry polling for the RACM600 library: each channel is read
+ *  more often the closer it runs to its warning or fault limit.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this
+ *  code to support the exploration and documentation of deep-water
+ *  ecosystems, contributing to their conservation and management. To
+ *  sustain our mission and initiatives, please consider donating at
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+
+#ifndef RACM600_ADAPTIVE_H
+#define RACM600_ADAPTIVE_H
+
+#include "RACM600.h"
+
+#ifndef RACM600_ADAPTIVE_MIN_PERIOD
+#define RACM600_ADAPTIVE_MIN_PERIOD 10000UL     // Period at the limit, 10 ms
+#endif
+#ifndef RACM600_ADAPTIVE_MAX_PERIOD
+#define RACM600_ADAPTIVE_MAX_PERIOD 2000000UL   // Period with plenty of headroom, 2 s
+#endif
+#ifndef RACM600_ADAPTIVE_RELAXED_HEADROOM
+#define RACM600_ADAPTIVE_RELAXED_HEADROOM 500   // Headroom (per mille of the limit) at which the period is longest
+#endif
+
+// Channels watched by RACM600AdaptivePoller, each against its limit
+enum RACM600AdaptiveChannel {
+    RACM600_ADAPT_VOUT = 0,         // READ_VOUT against VOUT_OV_FAULT_LIMIT, mV
+    RACM600_ADAPT_IOUT,             // READ_IOUT against IOUT_OC_WARN_LIMIT, mA
+    RACM600_ADAPT_TEMPERATURE_1,    // READ_TEMPERATURE_1..3 against OT_WARN_LIMIT, hundredths of a degree C
+    RACM600_ADAPT_TEMPERATURE_2,
+    RACM600_ADAPT_TEMPERATURE_3,
+    RACM600_ADAPT_CHANNELS
+};
+
+/*
+ * Reads the limits once in begin(), then schedules each channel on its own period. The
+ * period scales linearly from the minimum at the limit to the maximum at the relaxed
+ * headroom and beyond. When a channel is rising, the period is also capped at half the
+ * time its current slope needs to reach the limit, so fast ramps are caught early.
+ */
+template <class Bus = RACM600WireBus>
+class RACM600AdaptivePoller {
+public:
+    typedef RACM600Device<Bus> Device;
+
+    RACM600AdaptivePoller(Device& device)
+        : _device(&device), _minPeriod(RACM600_ADAPTIVE_MIN_PERIOD), _maxPeriod(RACM600_ADAPTIVE_MAX_PERIOD),
+          _relaxedHeadroom(RACM600_ADAPTIVE_RELAXED_HEADROOM), _limitsValid(false) {
+        resetStatistics();
+        for (uint8_t i = 0; i < RACM600_ADAPT_CHANNELS; i++) {
+            _limit[i] = 0;
+            _value[i] = 0;
+            _period[i] = _minPeriod;
+            _due[i] = 0;
+            _sampledAt[i] = 0;
+            _sampled[i] = false;
+        }
+    }
+
+    // Reads VOUT_MODE and the three limits, returns false if any could not be read. VOUT_MODE
+    // is read again rather than trusted from the cache, VOUT and its limit decode with it.
+    bool begin() {
+        uint16_t voutLimit, ioutLimit, tempLimit;
+        _limitsValid = _device->refreshVoutMode()
+                    && _device->tryReadWord(RACM600_VOUT_OV_FAULT_LIMIT, voutLimit) == RACM600_OK
+                    && _device->tryReadWord(RACM600_IOUT_OC_WARN_LIMIT, ioutLimit) == RACM600_OK
+                    && _device->tryReadWord(RACM600_OT_WARN_LIMIT, tempLimit) == RACM600_OK;
+        if (!_limitsValid) {
+            return false;
+        }
+
+        _limit[RACM600_ADAPT_VOUT] = RACM600Linear::decodeLinear16Scaled(voutLimit, _device->voutMode(), 1000);
+        _limit[RACM600_ADAPT_IOUT] = RACM600Linear::decodeLinear11Scaled(ioutLimit, 1000);
+        for (uint8_t i = RACM600_ADAPT_TEMPERATURE_1; i <= RACM600_ADAPT_TEMPERATURE_3; i++) {
+            _limit[i] = RACM600Linear::decodeLinear11Scaled(tempLimit, 100);
+        }
+
+        uint32_t now = _device->bus().micros();
+        for (uint8_t i = 0; i < RACM600_ADAPT_CHANNELS; i++) {
+            _due[i] = now;
+            _period[i] = _minPeriod;
+            _sampled[i] = false;
+        }
+        _start = now;
+        return true;
+    }
+
+    // Period range in microseconds, and the headroom (per mille of the limit) at which the
+    // longest period is reached
+    void setPeriods(uint32_t minMicros, uint32_t maxMicros) {
+        _minPeriod = minMicros;
+        _maxPeriod = maxMicros;
+    }
+    void setRelaxedHeadroom(uint16_t perMille) { _relaxedHeadroom = perMille; }
+
+    // Reads every channel that is due, returns the number of reads made
+    uint8_t tick() {
+        if (!_limitsValid) {
+            return 0;
+        }
+
+        uint8_t reads = 0;
+        for (uint8_t i = 0; i < RACM600_ADAPT_CHANNELS; i++) {
+            uint32_t now = _device->bus().micros();
+            if ((int32_t)(now - _due[i]) < 0) {
+                continue;
+            }
+
+            uint16_t raw;
+            RACM600Status status = _device->tryReadWord(command(i), raw);
+            uint32_t done = _device->bus().micros();
+            _busMicros += done - now;
+            _reads++;
+            reads++;
+
+            if (status != RACM600_OK) {
+                _failures++;
+                _due[i] = done + _minPeriod;    // Retry soon, the channel is blind until it reads
+                continue;
+            }
+
+            int32_t value = decode(i, raw);
+            _period[i] = nextPeriod(i, value, done);
+            _value[i] = value;
+            _sampledAt[i] = done;
+            _sampled[i] = true;
+            _due[i] = done + _period[i];
+        }
+        return reads;
+    }
+
+    // Last value read and the limit it is held against, in the units of RACM600AdaptiveChannel
+    int32_t value(uint8_t channel) const { return _value[channel]; }
+    int32_t limit(uint8_t channel) const { return _limit[channel]; }
+    bool sampled(uint8_t channel) const { return _sampled[channel]; }
+
+    // True once the last value read reached the limit
+    bool exceeded(uint8_t channel) const { return _sampled[channel] && _value[channel] >= _limit[channel]; }
+
+    // Current sample period of channel in microseconds
+    uint32_t period(uint8_t channel) const { return _period[channel]; }
+
+    // Bus time spent in reads, per mille of the time since begin() or resetStatistics()
+    uint16_t busUtilization() const {
+        uint32_t elapsed = _device->bus().micros() - _start;
+        return elapsed ? (uint16_t)((uint64_t)_busMicros * 1000 / elapsed) : 0;
+    }
+
+    uint32_t busMicros() const { return _busMicros; }
+    uint32_t reads() const { return _reads; }
+    uint32_t failures() const { return _failures; }
+
+    void resetStatistics() {
+        _busMicros = 0;
+        _reads = 0;
+        _failures = 0;
+        _start = _device->bus().micros();
+    }
+
+private:
+    static uint8_t command(uint8_t channel) {
+        switch (channel) {
+            case RACM600_ADAPT_VOUT:            return RACM600_READ_VOUT;
+            case RACM600_ADAPT_IOUT:            return RACM600_READ_IOUT;
+            case RACM600_ADAPT_TEMPERATURE_1:   return RACM600_READ_TEMPERATURE_1;
+            case RACM600_ADAPT_TEMPERATURE_2:   return RACM600_READ_TEMPERATURE_2;
+            default:                            return RACM600_READ_TEMPERATURE_3;
+        }
+    }
+
+    int32_t decode(uint8_t channel, uint16_t raw) const {
+        switch (channel) {
+            case RACM600_ADAPT_VOUT:    return RACM600Linear::decodeLinear16Scaled(raw, _device->voutMode(), 1000);
+            case RACM600_ADAPT_IOUT:    return RACM600Linear::decodeLinear11Scaled(raw, 1000);
+            default:                    return RACM600Linear::decodeLinear11Scaled(raw, 100);
+        }
+    }
+
+    uint32_t nextPeriod(uint8_t channel, int32_t value, uint32_t now) const {
+        int32_t limit = _limit[channel];
+        int32_t headroom = limit - value;
+        if (headroom <= 0 || limit <= 0) {
+            return _minPeriod;
+        }
+
+        // Linear in headroom, as per mille of the limit
+        uint32_t perMille = (uint32_t)((int64_t)headroom * 1000 / limit);
+        uint32_t period = _maxPeriod;
+        if (perMille < _relaxedHeadroom) {
+            period = _minPeriod + (uint32_t)((uint64_t)(_maxPeriod - _minPeriod) * perMille / _relaxedHeadroom);
+        }
+
+        // Rising: sample at least twice before the slope reaches the limit
+        if (_sampled[channel] && value > _value[channel]) {
+            uint32_t elapsed = now - _sampledAt[channel];
+            uint64_t timeToLimit = (uint64_t)headroom * elapsed / (uint32_t)(value - _value[channel]);
+            if (timeToLimit / 2 < period) {
+                period = timeToLimit / 2;
+            }
+        }
+        return period < _minPeriod ? _minPeriod : period;
+    }
+
+    Device* _device;
+    uint32_t _minPeriod;
+    uint32_t _maxPeriod;
+    uint16_t _relaxedHeadroom;
+    bool _limitsValid;
+
+    int32_t _limit[RACM600_ADAPT_CHANNELS];
+    int32_t _value[RACM600_ADAPT_CHANNELS];
+    uint32_t _period[RACM600_ADAPT_CHANNELS];
+    uint32_t _due[RACM600_ADAPT_CHANNELS];
+    uint32_t _sampledAt[RACM600_ADAPT_CHANNELS];
+    bool _sampled[RACM600_ADAPT_CHANNELS];
+
+    uint32_t _start;
+    uint32_t _busMicros;
+    uint32_t _reads;
+    uint32_t _failures;
+};
+
+#endif
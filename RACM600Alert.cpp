@@ -0,0 +1,71 @@
+/**
+ *   @file RACM600Alert.cpp
+ *
+ *  SMBALERT# handling for the RACM600 library.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this 
+ *  code to support the exploration and documentation of deep-water 
+ *  ecosystems, contributing to their conservation and management. To 
+ *  sustain our mission and initiatives, please consider donating at 
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+#ifdef ARDUINO
+#include "RACM600Alert.h"
+
+RACM600EventQueue<RACM600AlertEvent, RACM600_ALERT_QUEUE_SIZE> RACM600Alert::_queue;
+int16_t RACM600Alert::_pin = -1;
+
+// Registers a falling edge interrupt on the SMBALERT# pin, returns false if the pin has no interrupt
+bool RACM600Alert::attach(uint8_t pin) {
+    int interrupt = digitalPinToInterrupt(pin);
+    if (interrupt == NOT_AN_INTERRUPT) {
+        return false;
+    }
+    detach();
+    pinMode(pin, INPUT_PULLUP);   // SMBALERT# is open-drain
+    _pin = pin;
+    attachInterrupt(interrupt, isr, FALLING);
+    return true;
+}
+
+// Releases the SMBALERT# interrupt
+void RACM600Alert::detach() {
+    if (_pin >= 0) {
+        detachInterrupt(digitalPinToInterrupt(_pin));
+        _pin = -1;
+    }
+}
+
+// True when at least one alert event is waiting to be serviced
+bool RACM600Alert::pending() {
+    return !_queue.empty();
+}
+
+// True while some supply is still holding SMBALERT# low
+bool RACM600Alert::asserted() {
+    return _pin >= 0 && digitalRead(_pin) == LOW;
+}
+
+// Takes the oldest alert event, returns false when none is pending
+bool RACM600Alert::pop(RACM600AlertEvent& event) {
+    return _queue.pop(event);
+}
+
+// Alert events lost because the queue was full
+uint8_t RACM600Alert::dropped() {
+    return _queue.dropped();
+}
+
+// Interrupt handler, only timestamps the edge and queues it
+void RACM600Alert::isr() {
+    RACM600AlertEvent event;
+    event.timestamp = micros();
+    _queue.push(event);
+}
+#endif
@@ -0,0 +1,110 @@
+/**
+ *   @file RACM600Alert.h
+ *
+ *  SMBALERT# handling for the RACM600 library. A pin interrupt pushes alert
+ *  events into a lock-free single-producer/single-consumer queue, which the
+ *  sketch loop drains to perform the actual fault reads.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this 
+ *  code to support the exploration and documentation of deep-water 
+ *  ecosystems, contributing to their conservation and management. To 
+ *  sustain our mission and initiatives, please consider donating at 
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+
+#ifndef RACM600_ALERT_H
+#define RACM600_ALERT_H
+
+#include <Arduino.h>
+
+#ifndef RACM600_ALERT_QUEUE_SIZE
+#define RACM600_ALERT_QUEUE_SIZE 8  // Pending SMBALERT# events, must be a power of two
+#endif
+
+// Keeps the compiler from moving memory accesses across this point
+#define RACM600_COMPILER_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+// A single falling edge of SMBALERT#
+struct RACM600AlertEvent {
+    uint32_t timestamp;     // micros() inside the interrupt
+};
+
+/*
+ * Lock-free queue for exactly one producer (an ISR) and one consumer (the sketch loop)
+ * on a single core. Each index is written by one side only and is a single byte, so
+ * no interrupt masking is needed.
+ */
+template <typename T, uint8_t N>
+class RACM600EventQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "RACM600EventQueue size must be a power of two");
+
+public:
+    RACM600EventQueue() : _head(0), _tail(0), _dropped(0) {}
+
+    // Producer side, safe to call from an ISR. Returns false and counts a drop when full.
+    bool push(const T& item) {
+        uint8_t head = _head;
+        uint8_t next = (head + 1) & (N - 1);
+        if (next == _tail) {
+            if (_dropped != 0xFF) _dropped++;
+            return false;
+        }
+        _items[head] = item;
+        RACM600_COMPILER_BARRIER();   // Item must be stored before it is published
+        _head = next;
+        return true;
+    }
+
+    // Consumer side, returns false when empty
+    bool pop(T& item) {
+        uint8_t tail = _tail;
+        if (tail == _head) {
+            return false;
+        }
+        RACM600_COMPILER_BARRIER();   // Only read the item after seeing it published
+        item = _items[tail];
+        RACM600_COMPILER_BARRIER();
+        _tail = (tail + 1) & (N - 1);
+        return true;
+    }
+
+    bool empty() const { return _head == _tail; }
+
+    // Events lost because the queue was full, saturates at 255
+    uint8_t dropped() const { return _dropped; }
+
+private:
+    T _items[N];
+    volatile uint8_t _head;     // Written by the producer only
+    volatile uint8_t _tail;     // Written by the consumer only
+    volatile uint8_t _dropped;
+};
+
+/*
+ * Owns the single SMBALERT# line. SMBALERT# is open-drain and stays low until every
+ * alerting supply has been serviced, so after draining the queue the sketch should keep
+ * servicing while asserted() is true; no further edge arrives until the line is released.
+ */
+class RACM600Alert {
+public:
+    static bool attach(uint8_t pin);
+    static void detach();
+    static bool pending();
+    static bool asserted();
+    static bool pop(RACM600AlertEvent& event);
+    static uint8_t dropped();
+
+private:
+    static void isr();
+
+    static RACM600EventQueue<RACM600AlertEvent, RACM600_ALERT_QUEUE_SIZE> _queue;
+    static int16_t _pin;
+};
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ *   @file RACM600Bank.h
+ *
+ *  Round-robin scheduler for several RACM600 supplies sharing one I2C bus.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this 
+ *  code to support the exploration and documentation of deep-water 
+ *  ecosystems, contributing to their conservation and management. To 
+ *  sustain our mission and initiatives, please consider donating at 
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+
+#ifndef RACM600_BANK_H
+#define RACM600_BANK_H
+
+#include "RACM600.h"
+
+/*
+ * Owns up to N supplies on one Bus and spreads their snapshot reads over successive tick() calls.
+ *
+ * Fairness: the round-robin cursor carries over between ticks, and a tick never reads
+ * the same supply twice, so every supply is sampled once before any supply is sampled
+ * again. Each tick reads at least one supply even if the budget is smaller than a
+ * snapshot, so a tight budget slows the rotation but never stalls it.
+ */
+template <uint8_t N, class Bus = RACM600WireBus>
+class RACM600Bank {
+public:
+    typedef RACM600Device<Bus> Device;
+
+    RACM600Bank(const uint8_t addresses[], uint8_t count, uint32_t tickBudgetMicros = 1000, const Bus& bus = Bus())
+        : _bus(bus) {
+        _count = count < N ? count : N;
+        _cursor = 0;
+        _tickBudget = tickBudgetMicros;
+        _snapshotMicros = 0;
+        for (uint8_t i = 0; i < _count; i++) {
+            _devices[i] = Device(addresses[i], bus);
+            _sampled[i] = false;
+            _samples[i] = 0;
+            _failures[i] = 0;
+        }
+    }
+
+    // Starts the shared bus once and reads every supply's VOUT_MODE
+    void begin() {
+        _bus.begin();
+        for (uint8_t i = 0; i < _count; i++) {
+            _devices[i].refreshVoutMode();
+        }
+    }
+
+    // Time each tick() may spend on the bus, in microseconds
+    void setTickBudget(uint32_t budgetMicros) { _tickBudget = budgetMicros; }
+    uint32_t tickBudget() const { return _tickBudget; }
+
+    // Reads snapshots round robin until the next one would exceed the tick budget.
+    // Returns the number of supplies read this tick.
+    uint8_t tick() {
+        uint32_t start = _bus.micros();
+        uint8_t read = 0;
+
+        while (read < _count) {
+            uint32_t elapsed = _bus.micros() - start;
+            if (read > 0 && elapsed + _snapshotMicros > _tickBudget) {
+                break;
+            }
+
+            uint8_t i = _cursor;
+            _cursor = (_cursor + 1 == _count) ? 0 : _cursor + 1;
+
+            uint32_t snapshotStart = _bus.micros();
+            RACM600Snapshot snapshot;
+            if (_devices[i].readSnapshot(snapshot)) {
+                _snapshots[i] = snapshot;
+                _sampled[i] = true;
+                _samples[i]++;
+            } else {
+                _failures[i]++;
+            }
+            _snapshotMicros = _bus.micros() - snapshotStart;   // Predicts the cost of the next read
+            read++;
+        }
+        return read;
+    }
+
+    // Switches every output together with one Group Command transaction
+    bool enableOutputs() {
+        Device* devices[N];
+        return Device::groupEnableOutput(devicePointers(devices), _count);
+    }
+
+    bool disableOutputs() {
+        Device* devices[N];
+        return Device::groupDisableOutput(devicePointers(devices), _count);
+    }
+
+    // Sets the limits of page on every supply with one Group Command per changed limit, then
+    // verifies each supply's read-back. Returns the number set and verified. Supplies that
+    // already hold these limits cost no bus traffic.
+    uint8_t setLimits(const RACM600Limits& limits, uint8_t page = RACM600_PAGE_MAIN) {
+        Device* devices[N];
+        return Device::groupSetLimits(devicePointers(devices), _count, limits, page);
+    }
+
+    uint8_t size() const { return _count; }
+    Device& device(uint8_t i) { return _devices[i]; }
+
+    // Latest complete snapshot of supply i, check hasSample() first
+    const RACM600Snapshot& snapshot(uint8_t i) const { return _snapshots[i]; }
+    bool hasSample(uint8_t i) const { return _sampled[i]; }
+
+    // Microseconds since supply i was last sampled successfully, 0xFFFFFFFF if never
+    uint32_t staleness(uint8_t i) const {
+        return _sampled[i] ? _bus.micros() - _snapshots[i].timestamp : 0xFFFFFFFFUL;
+    }
+
+    // Largest staleness across the bank, the age of the oldest data the sketch holds
+    uint32_t maxStaleness() const {
+        uint32_t worst = 0;
+        for (uint8_t i = 0; i < _count; i++) {
+            uint32_t age = staleness(i);
+            if (age > worst) worst = age;
+        }
+        return worst;
+    }
+
+    // Successful and failed snapshot reads of supply i
+    uint32_t samples(uint8_t i) const { return _samples[i]; }
+    uint32_t failures(uint8_t i) const { return _failures[i]; }
+
+private:
+    // Fills devices with a pointer to each owned supply, for the static group functions
+    Device** devicePointers(Device** devices) {
+        for (uint8_t i = 0; i < _count; i++) {
+            devices[i] = &_devices[i];
+        }
+        return devices;
+    }
+
+    Bus _bus;
+    Device _devices[N];
+    RACM600Snapshot _snapshots[N];
+    bool _sampled[N];
+    uint32_t _samples[N];
+    uint32_t _failures[N];
+    uint8_t _count;
+    uint8_t _cursor;            // Next supply to read
+    uint32_t _tickBudget;
+    uint32_t _snapshotMicros;   // Duration of the last snapshot read
+};
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ *   @file RACM600Energy.h
+ *
+ *  Output energy accounting for the RACM600 library: trapezoidal integration
+ *  of READ_POUT over time in 64-bit fixed point, no floating point.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this
+ *  code to support the exploration and documentation of deep-water
+ *  ecosystems, contributing to their conservation and management. To
+ *  sustain our mission and initiatives, please consider donating at
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+
+#ifndef RACM600_ENERGY_H
+#define RACM600_ENERGY_H
+
+#include "RACM600.h"
+
+#ifndef RACM600_ENERGY_MAX_GAP_MICROS
+#define RACM600_ENERGY_MAX_GAP_MICROS 10000000UL   // Longest interval integrated, 10 s
+#endif
+
+#define RACM600_NANOJOULES_PER_MWH 3600000000LL
+
+/*
+ * Integrates output power samples into energy. Each interval between two samples adds
+ * (P0 + P1) / 2 * dt to a signed 64-bit count of nanojoules (mW x us), which holds about
+ * 2.5 MWh: 178 days at the full 600 W. A sample costs one 64-bit multiply (the 33-bit power
+ * sum by the 32-bit interval), a halving and a 64-bit add; divisions by anything else only
+ * happen when the result is read.
+ *
+ * Timestamps are micros() and may wrap, intervals are taken modulo 2^32. Missed samples
+ * simply make the next interval longer; an interval longer than the maximum gap is not
+ * integrated, since nothing is known about the power during it, and is counted by gaps()
+ * and gapMicros() instead so the budget can allow for it.
+ */
+class RACM600Energy {
+public:
+    RACM600Energy(uint32_t maxGapMicros = RACM600_ENERGY_MAX_GAP_MICROS) : _maxGap(maxGapMicros) {
+        reset();
+    }
+
+    // Zeroes the energy and statistics, the next sample starts a new series
+    void reset() {
+        _nanojoules = 0;
+        _integratedMicros = 0;
+        _gapMicros = 0;
+        _gaps = 0;
+        _samples = 0;
+        _hasLast = false;
+    }
+
+    void setMaxGap(uint32_t micros) { _maxGap = micros; }
+    uint32_t maxGap() const { return _maxGap; }
+
+    // Adds a power sample taken at timestamp (micros)
+    void add(uint32_t timestamp, int32_t milliwatts) {
+        if (_hasLast) {
+            uint32_t elapsed = timestamp - _lastTimestamp;   // Correct across one micros() wrap
+            if (elapsed > _maxGap) {
+                _gaps++;
+                _gapMicros += elapsed;
+            } else {
+                _nanojoules += ((int64_t)(_lastPower + milliwatts) * elapsed) / 2;
+                _integratedMicros += elapsed;
+            }
+        }
+        _lastTimestamp = timestamp;
+        _lastPower = milliwatts;
+        _hasLast = true;
+        _samples++;
+    }
+
+    // Adds the READ_POUT channel of a complete snapshot
+    void add(const RACM600Snapshot& snapshot) {
+        add(snapshot.timestamp, RACM600Linear::decodeLinear11Scaled(snapshot.raw[RACM600_CH_POUT], 1000));
+    }
+
+    // Reads READ_POUT from device and adds it, failed reads add nothing
+    template <class Bus>
+    bool sample(RACM600Device<Bus>& device) {
+        int32_t milliwatts;
+        if (device.tryReadPower_mW(milliwatts) != RACM600_OK) {
+            return false;
+        }
+        add(device.bus().micros(), milliwatts);
+        return true;
+    }
+
+    // Energy integrated so far
+    int64_t nanojoules() const { return _nanojoules; }
+    int64_t joules() const { return _nanojoules / 1000000000LL; }
+    int64_t milliwattHours() const { return _nanojoules / RACM600_NANOJOULES_PER_MWH; }
+
+    // Mean power over the integrated time, 0 before the first interval
+    int32_t averagePower_mW() const {
+        return _integratedMicros ? (int32_t)(_nanojoules / (int64_t)_integratedMicros) : 0;
+    }
+
+    uint64_t integratedMicros() const { return _integratedMicros; }
+    uint64_t gapMicros() const { return _gapMicros; }
+    uint32_t gaps() const { return _gaps; }
+    uint32_t samples() const { return _samples; }
+
+private:
+    int64_t _nanojoules;
+    uint64_t _integratedMicros;
+    uint64_t _gapMicros;
+    uint32_t _gaps;
+    uint32_t _samples;
+    uint32_t _maxGap;
+    uint32_t _lastTimestamp;
+    int32_t _lastPower;
+    bool _hasLast;
+};
+
+#endif
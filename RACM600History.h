@@ -0,0 +1,234 @@
+/**
+ *   @file RACM600History.h
+ *
+ *  Fixed size telemetry history for the RACM600 library: a ring buffer of
+ *  snapshots with streaming per-channel statistics, no heap allocation.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this
+ *  code to support the exploration and documentation of deep-water
+ *  ecosystems, contributing to their conservation and management. To
+ *  sustain our mission and initiatives, please consider donating at
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+
+#ifndef RACM600_HISTORY_H
+#define RACM600_HISTORY_H
+
+#include "RACM600.h"
+
+// Channels with statistics, every snapshot channel before STATUS_WORD
+#define RACM600_HISTORY_CHANNELS RACM600_CH_STATUS_WORD
+
+/*
+ * Count, min, max, mean and variance of a series of integers, O(1) per sample and in
+ * integer arithmetic only. The mean comes from an exact running sum. The variance uses
+ * Welford's update against a 24.8 fixed point mean recomputed from that sum on every
+ * sample, so rounding never accumulates however long the series runs. Samples must stay
+ * within +/-2^23 (the units of RACM600History::value() do).
+ */
+class RACM600Welford {
+public:
+    RACM600Welford() { reset(); }
+
+    void reset() {
+        _count = 0;
+        _min = 0x7FFFFFFF;
+        _max = -0x7FFFFFFF - 1;
+        _sum = 0;
+        _mean = 0;
+        _m2 = 0;
+    }
+
+    void add(int32_t value) {
+        int32_t scaled = value * 256;
+        _count++;
+        _sum += value;
+        int32_t delta = scaled - _mean;
+        _mean = (int32_t)(_sum * 256 / (int64_t)_count);
+        // delta and the updated delta share a sign but for the rounding of the mean, which
+        // can only make their product negative while both are within 1/256 of a unit
+        int64_t product = (int64_t)delta * (scaled - _mean);
+        if (product > 0) _m2 += (uint64_t)product >> 8;
+        if (value < _min) _min = value;
+        if (value > _max) _max = value;
+    }
+
+    uint32_t count() const { return _count; }
+
+    // min() and max() are only meaningful once count() is non-zero
+    int32_t min() const { return _min; }
+    int32_t max() const { return _max; }
+
+    // Exact sum of every sample
+    int64_t sum() const { return _sum; }
+
+    // Mean rounded to the nearest unit, halves away from zero
+    int32_t mean() const {
+        if (_count == 0) return 0;
+        int64_t half = _count / 2;
+        return (int32_t)((_sum + (_sum < 0 ? -half : half)) / (int64_t)_count);
+    }
+
+    // Sample variance in units squared, saturating at 0xFFFFFFFF. 0 below two samples.
+    uint32_t variance() const {
+        if (_count < 2) return 0;
+        uint64_t variance = (_m2 / (_count - 1) + 128) >> 8;
+        return variance > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)variance;
+    }
+
+    // Sample standard deviation in units, rounded down
+    uint32_t stddev() const {
+        uint32_t v = variance();
+        uint32_t root = 0;
+        for (uint32_t bit = 1UL << 30; bit != 0; bit >>= 2) {
+            if (v >= root + bit) {
+                v -= root + bit;
+                root = (root >> 1) + bit;
+            } else {
+                root >>= 1;
+            }
+        }
+        return root;
+    }
+
+private:
+    uint32_t _count;
+    int32_t _min;
+    int32_t _max;
+    int64_t _sum;
+    int32_t _mean;      // _sum / _count in 24.8 fixed point, rounded toward zero
+    uint64_t _m2;       // Sum of squared deviations, units squared in 56.8 fixed point
+};
+
+/*
+ * The last N snapshots in a statically sized ring buffer, plus statistics per channel over
+ * every sample pushed since clear(). Window queries walk the buffer in place from the newest
+ * sample back, nothing is copied.
+ *
+ * Channel values are decoded to integers: VOUT, VIN and VCAP in mV, IOUT in mA, POUT in mW
+ * and temperatures in hundredths of a degree Celsius.
+ *
+ * Snapshot timestamps are micros() and wrap after about 71 minutes, so time windows must be
+ * shorter than that. The cumulative statistics have no such limit.
+ */
+template <uint16_t N>
+class RACM600History {
+public:
+    RACM600History() { clear(); }
+
+    // Empties the buffer and restarts the statistics
+    void clear() {
+        _head = 0;
+        _size = 0;
+        _total = 0;
+        for (uint8_t i = 0; i < RACM600_HISTORY_CHANNELS; i++) {
+            _stats[i].reset();
+        }
+    }
+
+    // Appends a snapshot, overwriting the oldest once full
+    void push(const RACM600Snapshot& snapshot) {
+        _samples[_head] = snapshot;
+        _head = (_head + 1 == N) ? 0 : _head + 1;
+        if (_size < N) _size++;
+        _total++;
+        for (uint8_t i = 0; i < RACM600_HISTORY_CHANNELS; i++) {
+            _stats[i].add(value(snapshot, i));
+        }
+    }
+
+    // Reads a snapshot from device and pushes it, failed snapshots are not recorded
+    template <class Bus>
+    bool sample(RACM600Device<Bus>& device) {
+        RACM600Snapshot snapshot;
+        if (!device.readSnapshot(snapshot)) {
+            return false;
+        }
+        push(snapshot);
+        return true;
+    }
+
+    uint16_t capacity() const { return N; }
+    uint16_t size() const { return _size; }
+
+    // Samples pushed since clear(), including those since overwritten
+    uint32_t total() const { return _total; }
+
+    // Sample by age, 0 is the newest and size() - 1 the oldest still held
+    const RACM600Snapshot& at(uint16_t age) const {
+        uint16_t index = _head >= age + 1 ? _head - age - 1 : _head + N - age - 1;
+        return _samples[index];
+    }
+
+    // Statistics of channel over every sample since clear()
+    const RACM600Welford& stats(uint8_t channel) const { return _stats[channel]; }
+
+    // Statistics of channel over the newest count samples (fewer if not held)
+    RACM600Welford window(uint8_t channel, uint16_t count) const {
+        RACM600Welford stats;
+        if (count > _size) count = _size;
+        for (uint16_t age = 0; age < count; age++) {
+            stats.add(value(at(age), channel));
+        }
+        return stats;
+    }
+
+    // Statistics of channel over the samples taken within millis of the newest one
+    RACM600Welford windowMillis(uint8_t channel, uint32_t millis) const {
+        return window(channel, countWithin(millis));
+    }
+
+    // Number of samples taken within millis of the newest one. Timestamps only grow with
+    // age, so this is a binary search over ages.
+    uint16_t countWithin(uint32_t millis) const {
+        if (_size == 0) return 0;
+        uint32_t newest = at(0).timestamp;
+        uint32_t span = millis * 1000UL;
+        uint16_t low = 1;
+        uint16_t high = _size;
+        while (low < high) {
+            uint16_t middle = low + (high - low) / 2;
+            if (newest - at(middle).timestamp <= span) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+    // Channel of snapshot decoded to an integer in the units listed above
+    static int32_t value(const RACM600Snapshot& snapshot, uint8_t channel) {
+        uint16_t raw = snapshot.raw[channel];
+        switch (channel) {
+            case RACM600_CH_VOUT:
+                return RACM600Linear::decodeLinear16Scaled(raw, snapshot.voutMode, 1000);
+            case RACM600_CH_IOUT:
+            case RACM600_CH_POUT:
+            case RACM600_CH_VIN:
+            case RACM600_CH_VCAP:
+                return RACM600Linear::decodeLinear11Scaled(raw, 1000);
+            case RACM600_CH_TEMPERATURE_1:
+            case RACM600_CH_TEMPERATURE_2:
+            case RACM600_CH_TEMPERATURE_3:
+                return RACM600Linear::decodeLinear11Scaled(raw, 100);
+            default:
+                return raw;
+        }
+    }
+
+private:
+    RACM600Snapshot _samples[N];
+    uint16_t _head;                 // Slot the next push() writes
+    uint16_t _size;
+    uint32_t _total;
+    RACM600Welford _stats[RACM600_HISTORY_CHANNELS];
+};
+
+#endif
@@ -0,0 +1,1195 @@
+/**
+ *   @file RACM600Impl.h
+ *
+ *  Member definitions of the RACM600Device template, included at the end of
+ *  RACM600.h. Do not include this file directly.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this 
+ *  code to support the exploration and documentation of deep-water 
+ *  ecosystems, contributing to their conservation and management. To 
+ *  sustain our mission and initiatives, please consider donating at 
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+
+#ifndef RACM600_IMPL_H
+#define RACM600_IMPL_H
+
+template <class Bus>
+RACM600Device<Bus>::RACM600Device(uint8_t i2c_address, const Bus& bus) : _bus(bus) {
+    _address = i2c_address;
+    _pec = false;
+    _pecErrors = 0;
+    _retryLimit = 0;
+    _retryBackoff = 0;
+    _retries = 0;
+    _lastStatus = RACM600_OK;
+    _page = RACM600_PAGE_UNKNOWN;
+    _pageWrites = 0;
+    _voutMode = 0;
+    _voutModeValid = false;
+    _voutScale = 1.0f;
+    _auxVoutMode = 0;
+    _auxVoutModeValid = false;
+    _faultsValid = false;
+    _faultsUnread = 0;
+    _ratings = Ratings();
+    _ratingsValid = false;
+    _limitsKnown = 0;
+    _limitsPending = 0;
+    _limitWrites = 0;
+    _wireBytes = 0;
+    _lastHealthCheckBytes = 0;
+    _pollState = POLL_IDLE;
+    _pollCommand = 0;
+    _pollSucceeded = false;
+    _pollData[0] = 0;
+    _pollData[1] = 0;
+    _pollData[2] = 0;
+    _pollStart = 0;
+    _pollLatency = 0;
+    _pollMaxStep = 0;
+}
+
+template <class Bus>
+void RACM600Device<Bus>::begin() {
+    _bus.begin();
+    refreshVoutMode();
+}
+
+// Generic Read Function, 0 if the read failed
+template <class Bus>
+uint16_t RACM600Device<Bus>::readCommand(uint8_t cmd) {
+    uint16_t value;
+    if (tryReadWord(cmd, value) == RACM600_OK) {
+        return value;
+    }
+    return 0;
+}
+
+// Reads a 2 byte register, raw is only written on success
+template <class Bus>
+RACM600Status RACM600Device<Bus>::tryReadWord(uint8_t cmd, uint16_t& raw) {
+    uint8_t data[2];
+    RACM600Status status = readBytes(cmd, data, 2);
+    if (status == RACM600_OK) {
+        raw = (data[1] << 8) | data[0];
+    }
+    return status;
+}
+
+// Reads a 1 byte register, raw is only written on success
+template <class Bus>
+RACM600Status RACM600Device<Bus>::tryReadByte(uint8_t cmd, uint8_t& raw) {
+    return readBytes(cmd, &raw, 1);
+}
+
+// Reads a 2 byte register of the given page, PAGE is only written if the other page is selected
+template <class Bus>
+RACM600Status RACM600Device<Bus>::tryReadWord(uint8_t cmd, uint8_t page, uint16_t& raw) {
+    uint8_t data[2];
+    RACM600Status status = readBytes(cmd, data, 2, page);
+    if (status == RACM600_OK) {
+        raw = (data[1] << 8) | data[0];
+    }
+    return status;
+}
+
+// Reads a 1 byte register of the given page
+template <class Bus>
+RACM600Status RACM600Device<Bus>::tryReadByte(uint8_t cmd, uint8_t page, uint8_t& raw) {
+    return readBytes(cmd, &raw, 1, page);
+}
+
+// Reads length bytes of cmd from page (ignored for unpaged registers), retrying failed attempts
+// with a doubling backoff per the retry policy
+template <class Bus>
+RACM600Status RACM600Device<Bus>::readBytes(uint8_t cmd, uint8_t* data, uint8_t length, uint8_t page) {
+    if (page > RACM600_PAGE_AUX) {
+        _lastStatus = RACM600_INVALID;
+        return RACM600_INVALID;
+    }
+    if (isPaged(cmd) && !setPage(page)) {
+        _lastStatus = RACM600_BUS_ERROR;
+        return RACM600_BUS_ERROR;
+    }
+
+    RACM600Status status = retryRead(cmd, data, length, readAttempt(cmd, data, length));
+    _lastStatus = status;
+    return status;
+}
+
+// Retries a read whose first attempt returned status, per the retry policy with a doubling backoff
+template <class Bus>
+RACM600Status RACM600Device<Bus>::retryRead(uint8_t cmd, uint8_t* data, uint8_t length, RACM600Status status) {
+    uint32_t backoff = _retryBackoff;
+    for (uint8_t attempt = 0; attempt < _retryLimit && status != RACM600_OK && status != RACM600_INVALID; attempt++) {
+        _bus.delayMicros(backoff);
+        backoff = backoff * 2 > RACM600_MAX_BACKOFF_MICROS ? RACM600_MAX_BACKOFF_MICROS : backoff * 2;
+        _retries++;
+        status = readAttempt(cmd, data, length);
+    }
+    return status;
+}
+
+// Writes cmd, then reads length bytes (plus the PEC byte when enabled) after a repeated start.
+// data is only written when the whole read, PEC included, succeeded.
+template <class Bus>
+RACM600Status RACM600Device<Bus>::readAttempt(uint8_t cmd, uint8_t* data, uint8_t length) {
+    uint8_t buffer[RACM600_MAX_DATA_LENGTH + 1];
+    uint8_t total = length + (_pec ? 1 : 0);
+    if (total > sizeof(buffer)) {
+        return RACM600_INVALID;
+    }
+
+    uint32_t start = statsMicros();
+    _wireBytes += 3 + total;    // Address, command, repeated start address, data
+    RACM600Status status = _bus.writeRead(_address, &cmd, 1, buffer, total) ? RACM600_OK : RACM600_BUS_ERROR;
+    if (status == RACM600_OK && _pec && buffer[length] != readPec(cmd, buffer, length)) {
+        _pecErrors++;
+        status = RACM600_PEC_ERROR;
+    }
+    statsRecord(cmd, statsMicros() - start, 3 + total, status == RACM600_OK);
+    if (status != RACM600_OK) {
+        return status;
+    }
+    for (uint8_t i = 0; i < length; i++) {
+        data[i] = buffer[i];
+    }
+    return RACM600_OK;
+}
+
+// Writes cmd followed by length data bytes (plus the PEC byte when enabled), returns false
+// if the device did not acknowledge. With stop = false the bus is held for a repeated start.
+template <class Bus>
+bool RACM600Device<Bus>::writeBytes(uint8_t cmd, const uint8_t* data, uint8_t length, bool stop) {
+    uint8_t buffer[RACM600_MAX_DATA_LENGTH + 2];
+    if (length > RACM600_MAX_DATA_LENGTH) {
+        return false;
+    }
+
+    buffer[0] = cmd;
+    for (uint8_t i = 0; i < length; i++) {
+        buffer[i + 1] = data[i];
+    }
+    uint8_t total = length + 1;
+    if (_pec) {
+        buffer[total++] = writePec(cmd, data, length);
+    }
+    uint32_t start = statsMicros();
+    _wireBytes += 1 + total;    // Address, command, data, PEC
+    bool ok = _bus.write(_address, buffer, total, stop);
+    statsRecord(cmd, statsMicros() - start, 1 + total, ok);
+    return ok;
+}
+
+// Bus time for instrumentation, a constant 0 when RACM600_STATS is not defined
+template <class Bus>
+inline uint32_t RACM600Device<Bus>::statsMicros() {
+#ifdef RACM600_STATS
+    return _bus.micros();
+#else
+    return 0;
+#endif
+}
+
+// Hands one finished transaction to RACM600Stats, compiles to nothing without RACM600_STATS
+template <class Bus>
+inline void RACM600Device<Bus>::statsRecord(uint8_t cmd, uint32_t micros, uint8_t bytes, bool ok) {
+#ifdef RACM600_STATS
+    RACM600Stats::record(cmd, micros, bytes, ok);
+#else
+    (void)cmd; (void)micros; (void)bytes; (void)ok;
+#endif
+}
+
+// PEC of a read transaction: address+W, command, address+R, data
+template <class Bus>
+uint8_t RACM600Device<Bus>::readPec(uint8_t cmd, const uint8_t* data, uint8_t length) const {
+    uint8_t crc = RACM600Pec::update(0, _address << 1);
+    crc = RACM600Pec::update(crc, cmd);
+    crc = RACM600Pec::update(crc, (_address << 1) | 1);
+    return RACM600Pec::update(crc, data, length);
+}
+
+// PEC of a write transaction: address+W, command, data
+template <class Bus>
+uint8_t RACM600Device<Bus>::writePec(uint8_t cmd, const uint8_t* data, uint8_t length) const {
+    uint8_t crc = RACM600Pec::update(0, _address << 1);
+    crc = RACM600Pec::update(crc, cmd);
+    return RACM600Pec::update(crc, data, length);
+}
+
+// Turns Packet Error Checking on or off for every transaction of this instance
+template <class Bus>
+void RACM600Device<Bus>::setPec(bool enabled) {
+    _pec = enabled;
+}
+
+template <class Bus>
+bool RACM600Device<Bus>::pecEnabled() const {
+    return _pec;
+}
+
+// Reads rejected because their PEC did not match
+template <class Bus>
+uint32_t RACM600Device<Bus>::pecErrors() const {
+    return _pecErrors;
+}
+
+// Generic Write Function, returns false if the device did not acknowledge
+template <class Bus>
+bool RACM600Device<Bus>::writeCommand(uint8_t cmd, uint16_t value) {
+    uint8_t data[2] = { lowByte(value), highByte(value) };
+    return writeBytes(cmd, data, 2);
+}
+
+// Enable Power Output. OPERATION is paged, so Page 0 is selected first.
+template <class Bus>
+void RACM600Device<Bus>::enableOutput() {
+    uint8_t operation = 0x80;  // Bit 7: ON
+    if (setPage(RACM600_PAGE_MAIN)) {
+        writeBytes(RACM600_OPERATION, &operation, 1);
+    }
+}
+
+// Disable Power Output of Page 0
+template <class Bus>
+void RACM600Device<Bus>::disableOutput() {
+    uint8_t operation = 0x00;  // Bit 7: OFF
+    if (setPage(RACM600_PAGE_MAIN)) {
+        writeBytes(RACM600_OPERATION, &operation, 1);
+    }
+}
+
+// Clear Faults
+template <class Bus>
+void RACM600Device<Bus>::clearFaults() {
+    writeBytes(RACM600_CLEAR_FAULTS, NULL, 0);  // Send-Byte, no data
+    resetFaultCache();
+}
+
+// Reads VOUT_MODE of page and caches it, with the LINEAR16 scale for Page 0 READ_VOUT
+template <class Bus>
+bool RACM600Device<Bus>::refreshVoutMode(uint8_t page) {
+    uint8_t mode;
+    if (tryReadByte(RACM600_VOUT_MODE, page, mode) != RACM600_OK) {
+        return false;
+    }
+
+    if (page == RACM600_PAGE_AUX) {
+        _auxVoutMode = mode;
+        _auxVoutModeValid = true;
+        return true;
+    }
+
+    // Bits 4:0 hold a two's complement exponent, the scale is 2^exponent
+    _voutMode = mode;
+    _voutScale = RACM600Linear::scale(mode);
+    _voutModeValid = true;
+    return true;
+}
+
+// Returns the cached VOUT_MODE byte of page
+template <class Bus>
+uint8_t RACM600Device<Bus>::voutMode(uint8_t page) const {
+    return page == RACM600_PAGE_AUX ? _auxVoutMode : _voutMode;
+}
+
+// Selects page, writing PAGE only when it differs from the shadowed page
+template <class Bus>
+bool RACM600Device<Bus>::setPage(uint8_t page) {
+    if (page == _page) {
+        return true;
+    }
+    _pageWrites++;
+    if (!writeBytes(RACM600_PAGE, &page, 1)) {
+        _page = RACM600_PAGE_UNKNOWN;   // The device may or may not have switched
+        return false;
+    }
+    _page = page;
+    return true;
+}
+
+// Shadowed PAGE, RACM600_PAGE_UNKNOWN until the first PAGE write
+template <class Bus>
+uint8_t RACM600Device<Bus>::page() const {
+    return _page;
+}
+
+// Forgets the shadowed PAGE, for when something else may have changed it (another master,
+// a power cycle of the supply). The next paged read writes PAGE again.
+template <class Bus>
+void RACM600Device<Bus>::invalidatePage() {
+    _page = RACM600_PAGE_UNKNOWN;
+}
+
+// PAGE writes issued by this instance since construction
+template <class Bus>
+uint32_t RACM600Device<Bus>::pageWrites() const {
+    return _pageWrites;
+}
+
+// Sends cmd and data to every device in one Group Command transaction. Each device gets its own
+// address segment after a repeated start, and the single STOP at the end makes them all execute.
+// A paged cmd goes to Page 0: PAGE is written to each device on its own beforehand, as a Group
+// Command must not change it, and devices whose PAGE write fails are left out.
+template <class Bus>
+bool RACM600Device<Bus>::groupWrite(RACM600Device* const devices[], uint8_t count, uint8_t cmd, const uint8_t* data, uint8_t length) {
+    bool acknowledged = true;
+    bool paged = isPaged(cmd);
+    uint8_t last = count;
+    for (uint8_t i = 0; i < count; i++) {
+        if (!paged || devices[i]->setPage(RACM600_PAGE_MAIN)) {
+            last = i;
+        } else {
+            acknowledged = false;
+        }
+    }
+    if (last == count) {
+        return false;
+    }
+
+    // Each segment carries its own PEC, only the last one ends with a STOP
+    for (uint8_t i = 0; i <= last; i++) {
+        if (paged && devices[i]->_page != RACM600_PAGE_MAIN) {
+            continue;
+        }
+        if (!devices[i]->writeBytes(cmd, data, length, i == last)) {
+            acknowledged = false;
+        }
+    }
+    return acknowledged;
+}
+
+// Writes a word register on every device in one Group Command transaction
+template <class Bus>
+bool RACM600Device<Bus>::groupWriteCommand(RACM600Device* const devices[], uint8_t count, uint8_t cmd, uint16_t value) {
+    uint8_t data[2] = { lowByte(value), highByte(value) };
+    return groupWrite(devices, count, cmd, data, 2);
+}
+
+// Group Command form of setLimits() for many devices. Devices whose PAGE or VOUT_MODE cannot be
+// read are left out. Devices get the same Group Command when their encoded values match, which
+// is always the case for the LINEAR11 current limits; a different VOUT_MODE for VOUT_OV_FAULT
+// needs its own. A segment that is not acknowledged only fails its device's read-back.
+template <class Bus>
+uint8_t RACM600Device<Bus>::groupSetLimits(RACM600Device* const devices[], uint8_t count, const Limits& limits, uint8_t page) {
+    if (page > RACM600_PAGE_AUX) {
+        return 0;
+    }
+    int32_t values[RACM600_LIMITS] = { limits.voutOvFault_mV, limits.ioutOcFault_mA, limits.ioutOcWarn_mA };
+
+    // PAGE goes to each device on its own, as a Group Command must not change it, and only to
+    // devices with something to send
+    for (uint8_t i = 0; i < count; i++) {
+        RACM600Device* device = devices[i];
+        device->_limitsPending = 0;
+        if (!device->voutModeValid(page) && !(device->setPage(page) && device->ensureVoutMode(page))) {
+            continue;
+        }
+        uint8_t stale = device->staleLimits(values, (1 << RACM600_LIMITS) - 1, page);
+        if (stale != 0 && device->setPage(page)) {
+            device->_limitsPending = stale;
+        }
+    }
+
+    for (uint8_t limit = 0; limit < RACM600_LIMITS; limit++) {
+        uint8_t bit = 1 << limit;
+        for (;;) {
+            // One Group Command per distinct encoding, from the first device still pending to the last sharing it
+            uint8_t first = count;
+            for (uint8_t i = 0; i < count && first == count; i++) {
+                if (devices[i]->_limitsPending & bit) first = i;
+            }
+            if (first == count) {
+                break;
+            }
+            uint16_t raw = encodeLimit(limit, values[limit], devices[first]->voutMode(page));
+            uint8_t last = first;
+            for (uint8_t i = first + 1; i < count; i++) {
+                if ((devices[i]->_limitsPending & bit) && encodeLimit(limit, values[limit], devices[i]->voutMode(page)) == raw) {
+                    last = i;
+                }
+            }
+
+            uint8_t data[2] = { lowByte(raw), highByte(raw) };
+            for (uint8_t i = first; i <= last; i++) {
+                RACM600Device* device = devices[i];
+                if ((device->_limitsPending & bit) && encodeLimit(limit, values[limit], device->voutMode(page)) == raw) {
+                    device->_limitsPending &= ~bit;
+                    device->markLimitWritten(limit, page);
+                    device->writeBytes(LIMIT_COMMANDS[limit], data, 2, i == last);
+                }
+            }
+        }
+    }
+
+    // Every limit whose shadow is unknown now was just sent. Devices that were left out keep
+    // stale shadows and are not counted.
+    uint8_t verified = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        RACM600Device* device = devices[i];
+        if (!device->voutModeValid(page)) {
+            continue;
+        }
+        uint8_t sent = ~(device->_limitsKnown >> (page * RACM600_LIMITS)) & ((1 << RACM600_LIMITS) - 1);
+        if (sent != 0 && (device->_page != page || device->verifyLimits(values, sent, page) != RACM600_OK)) {
+            continue;
+        }
+        if (device->staleLimits(values, (1 << RACM600_LIMITS) - 1, page) == 0) {
+            verified++;
+        }
+    }
+    return verified;
+}
+
+// Turns every output on at the same moment
+template <class Bus>
+bool RACM600Device<Bus>::groupEnableOutput(RACM600Device* const devices[], uint8_t count) {
+    uint8_t operation = 0x80;  // Bit 7: ON
+    return groupWrite(devices, count, RACM600_OPERATION, &operation, 1);
+}
+
+// Turns every output off at the same moment
+template <class Bus>
+bool RACM600Device<Bus>::groupDisableOutput(RACM600Device* const devices[], uint8_t count) {
+    uint8_t operation = 0x00;  // Bit 7: OFF
+    return groupWrite(devices, count, RACM600_OPERATION, &operation, 1);
+}
+
+// Read Output Voltage
+template <class Bus>
+float RACM600Device<Bus>::readVoltage() {
+    if (!_voutModeValid) {
+        refreshVoutMode();  // begin() could not reach the device, try again now
+    }
+    uint16_t raw = readCommand(RACM600_READ_VOUT);  // READ_VOUT Command
+    return raw * _voutScale;  // LINEAR16 mantissa scaled by the VOUT_MODE exponent
+}
+
+// Read Output Current
+template <class Bus>
+float RACM600Device<Bus>::readCurrent() {
+    uint16_t raw = readCommand(RACM600_READ_IOUT);  // READ_IOUT Command
+    return RACM600Linear::decodeLinear11(raw);  // LINEAR11 Amperes
+}
+
+// Read Temperature of the air around the power supply
+template <class Bus>
+float RACM600Device<Bus>::readAmbientTemperature() {
+    uint16_t raw = readCommand(RACM600_READ_TEMPERATURE_1);  // READ_TEMPERATURE_1 Command
+    return RACM600Linear::decodeLinear11(raw);  // LINEAR11 °C
+}
+
+// Read Temperature of the power factor correction circuit
+template <class Bus>
+float RACM600Device<Bus>::readACINPUTTemperature() {
+    uint16_t raw = readCommand(RACM600_READ_TEMPERATURE_2);  // READ_TEMPERATURE_2 Command
+    return RACM600Linear::decodeLinear11(raw);  // LINEAR11 °C
+}
+
+// Read Temperature of the LLC resonant converter stage
+template <class Bus>
+float RACM600Device<Bus>::readDCOUTPUTTemperature() {
+    uint16_t raw = readCommand(RACM600_READ_TEMPERATURE_3);  // READ_TEMPERATURE_3 Command
+    return RACM600Linear::decodeLinear11(raw);  // LINEAR11 °C
+}
+
+// Read Output Power
+template <class Bus>
+float RACM600Device<Bus>::readPower() {
+    uint16_t raw = readCommand(RACM600_READ_POUT);  // READ_POUT Command
+    return RACM600Linear::decodeLinear11(raw);  // LINEAR11 Watts
+}
+
+// Reads every snapshot register of Page 0 back to back as one batch, returns false if any read
+// failed or VOUT_MODE is unknown, since READ_VOUT cannot be decoded without it
+template <class Bus>
+bool RACM600Device<Bus>::readSnapshot(Snapshot& snapshot) {
+    snapshot.timestamp = _bus.micros();
+    uint16_t raw[RACM600_SNAPSHOT_CHANNELS];
+    bool selected = setPage(RACM600_PAGE_MAIN) && ensureVoutMode(RACM600_PAGE_MAIN);
+    snapshot.voutMode = _voutMode;
+    bool complete = readBatch(SNAPSHOT_COMMANDS, RACM600_SNAPSHOT_CHANNELS, raw) && selected;
+    for (uint8_t i = 0; i < RACM600_SNAPSHOT_CHANNELS; i++) {
+        snapshot.raw[i] = raw[i];   // Snapshot is packed, copy element by element
+    }
+    return complete;
+}
+
+// Reads every AUX snapshot register of Page 1 back to back as one batch, returns false if any
+// read failed or the AUX VOUT_MODE is unknown
+template <class Bus>
+bool RACM600Device<Bus>::readAuxSnapshot(AuxSnapshot& snapshot) {
+    snapshot.timestamp = _bus.micros();
+    bool selected = setPage(RACM600_PAGE_AUX) && ensureVoutMode(RACM600_PAGE_AUX);
+    snapshot.voutMode = _auxVoutMode;
+    uint16_t raw[RACM600_AUX_CHANNELS];
+    bool complete = readBatch(AUX_SNAPSHOT_COMMANDS, RACM600_AUX_CHANNELS, raw) && selected;
+    for (uint8_t i = 0; i < RACM600_AUX_CHANNELS; i++) {
+        snapshot.raw[i] = raw[i];
+    }
+    return complete;
+}
+
+// Main and AUX sweep. Starting with the page already selected keeps it to one PAGE write,
+// two when the page is unknown.
+template <class Bus>
+bool RACM600Device<Bus>::readSnapshot(Snapshot& snapshot, AuxSnapshot& aux) {
+    if (_page == RACM600_PAGE_AUX) {
+        bool complete = readAuxSnapshot(aux);
+        return readSnapshot(snapshot) && complete;
+    }
+    bool complete = readSnapshot(snapshot);
+    return readAuxSnapshot(aux) && complete;
+}
+
+// Reads every MFR_* rating in one batch and caches them, returns false (keeping any earlier
+// ratings) if a read failed
+template <class Bus>
+bool RACM600Device<Bus>::readRatings() {
+    uint16_t raw[RACM600_RATINGS];
+    if (!_voutModeValid && !refreshVoutMode()) {
+        return false;
+    }
+    if (!readBatch(RATING_COMMANDS, RACM600_RATINGS, raw)) {
+        return false;
+    }
+    decodeRatings(raw, _voutMode, _ratings);
+    _ratingsValid = true;
+    return true;
+}
+
+// Cached ratings, read on first use. All zero while the device cannot be read.
+template <class Bus>
+const RACM600Ratings& RACM600Device<Bus>::ratings() {
+    if (!_ratingsValid) {
+        readRatings();
+    }
+    return _ratings;
+}
+
+template <class Bus>
+bool RACM600Device<Bus>::ratingsValid() const {
+    return _ratingsValid;
+}
+
+// Sets VOUT_OV_FAULT_LIMIT of page
+template <class Bus>
+RACM600Status RACM600Device<Bus>::setVoutOvFaultLimit_mV(int32_t millivolts, uint8_t page) {
+    int32_t values[RACM600_LIMITS] = { millivolts, 0, 0 };
+    return writeLimits(values, 1 << RACM600_LIMIT_VOUT_OV_FAULT, page);
+}
+
+// Sets IOUT_OC_FAULT_LIMIT of page
+template <class Bus>
+RACM600Status RACM600Device<Bus>::setIoutOcFaultLimit_mA(int32_t milliamps, uint8_t page) {
+    int32_t values[RACM600_LIMITS] = { 0, milliamps, 0 };
+    return writeLimits(values, 1 << RACM600_LIMIT_IOUT_OC_FAULT, page);
+}
+
+// Sets IOUT_OC_WARN_LIMIT of page
+template <class Bus>
+RACM600Status RACM600Device<Bus>::setIoutOcWarnLimit_mA(int32_t milliamps, uint8_t page) {
+    int32_t values[RACM600_LIMITS] = { 0, 0, milliamps };
+    return writeLimits(values, 1 << RACM600_LIMIT_IOUT_OC_WARN, page);
+}
+
+// Sets every limit of page, verifying all the writes with a single batch
+template <class Bus>
+RACM600Status RACM600Device<Bus>::setLimits(const Limits& limits, uint8_t page) {
+    int32_t values[RACM600_LIMITS] = { limits.voutOvFault_mV, limits.ioutOcFault_mA, limits.ioutOcWarn_mA };
+    return writeLimits(values, (1 << RACM600_LIMITS) - 1, page);
+}
+
+// Reads every limit of page in one batch and refreshes the shadows, limits is only written on success
+template <class Bus>
+RACM600Status RACM600Device<Bus>::readLimits(Limits& limits, uint8_t page) {
+    if (page > RACM600_PAGE_AUX) {
+        return RACM600_INVALID;
+    }
+    uint16_t raw[RACM600_LIMITS];
+    if (!setPage(page) || !ensureVoutMode(page) || !readBatch(LIMIT_COMMANDS, RACM600_LIMITS, raw)) {
+        return RACM600_BUS_ERROR;
+    }
+    for (uint8_t i = 0; i < RACM600_LIMITS; i++) {
+        _limits[page][i] = decodeLimit(i, raw[i], voutMode(page));
+        _limitsKnown |= 1 << (page * RACM600_LIMITS + i);
+    }
+    limits.voutOvFault_mV = _limits[page][RACM600_LIMIT_VOUT_OV_FAULT];
+    limits.ioutOcFault_mA = _limits[page][RACM600_LIMIT_IOUT_OC_FAULT];
+    limits.ioutOcWarn_mA = _limits[page][RACM600_LIMIT_IOUT_OC_WARN];
+    return RACM600_OK;
+}
+
+// Forgets the limit shadows, for when something else may have changed the limits (another
+// master, a power cycle of the supply). The next setter writes and verifies again.
+template <class Bus>
+void RACM600Device<Bus>::invalidateLimits() {
+    _limitsKnown = 0;
+}
+
+// Limit writes issued by this instance since construction, skipped writes not counted
+template <class Bus>
+uint32_t RACM600Device<Bus>::limitWrites() const {
+    return _limitWrites;
+}
+
+// Writes the limits selected by mask whose encoded value differs from the shadow, then reads
+// back every register written in one batch. PAGE is selected once, before the first write, and
+// not at all when the shadows already match.
+template <class Bus>
+RACM600Status RACM600Device<Bus>::writeLimits(const int32_t* values, uint8_t mask, uint8_t page) {
+    if (page > RACM600_PAGE_AUX) {
+        return RACM600_INVALID;
+    }
+    if (voutModeValid(page) && staleLimits(values, mask, page) == 0) {
+        return RACM600_OK;
+    }
+    if (!setPage(page) || !ensureVoutMode(page)) {
+        return RACM600_BUS_ERROR;
+    }
+
+    uint8_t stale = staleLimits(values, mask, page);
+    for (uint8_t i = 0; i < RACM600_LIMITS; i++) {
+        if (stale & (1 << i)) {
+            markLimitWritten(i, page);
+            if (!writeCommand(LIMIT_COMMANDS[i], encodeLimit(i, values[i], voutMode(page)))) {
+                return RACM600_BUS_ERROR;
+            }
+        }
+    }
+    return verifyLimits(values, stale, page);
+}
+
+// Limits selected by mask whose shadow does not hold values as encoded. VOUT_MODE of page must be known.
+template <class Bus>
+uint8_t RACM600Device<Bus>::staleLimits(const int32_t* values, uint8_t mask, uint8_t page) const {
+    uint8_t mode = voutMode(page);
+    uint8_t stale = 0;
+    for (uint8_t i = 0; i < RACM600_LIMITS; i++) {
+        if (!(mask & (1 << i))) {
+            continue;
+        }
+        int32_t target = decodeLimit(i, encodeLimit(i, values[i], mode), mode);
+        uint8_t known = 1 << (page * RACM600_LIMITS + i);
+        if (!(_limitsKnown & known) || _limits[page][i] != target) {
+            stale |= 1 << i;
+        }
+    }
+    return stale;
+}
+
+// The shadow of a limit about to be written is unknown until read back
+template <class Bus>
+void RACM600Device<Bus>::markLimitWritten(uint8_t limit, uint8_t page) {
+    _limitsKnown &= ~(1 << (page * RACM600_LIMITS + limit));
+    _limitWrites++;
+}
+
+// Reads back the limits selected by mask in one batch on the selected page, refreshing their
+// shadows, and checks them against values
+template <class Bus>
+RACM600Status RACM600Device<Bus>::verifyLimits(const int32_t* values, uint8_t mask, uint8_t page) {
+    uint8_t written[RACM600_LIMITS];
+    uint8_t commands[RACM600_LIMITS];
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < RACM600_LIMITS; i++) {
+        if (mask & (1 << i)) {
+            written[count] = i;
+            commands[count] = LIMIT_COMMANDS[i];
+            count++;
+        }
+    }
+    if (count == 0) {
+        return RACM600_OK;
+    }
+
+    uint16_t readBack[RACM600_LIMITS];
+    if (!readBatch(commands, count, readBack)) {
+        return RACM600_BUS_ERROR;
+    }
+
+    // Compared as decoded values, a device may store the same value with another exponent
+    uint8_t mode = voutMode(page);
+    RACM600Status status = RACM600_OK;
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t limit = written[i];
+        int32_t value = decodeLimit(limit, readBack[i], mode);
+        _limits[page][limit] = value;
+        _limitsKnown |= 1 << (page * RACM600_LIMITS + limit);
+        if (value != decodeLimit(limit, encodeLimit(limit, values[limit], mode), mode)) {
+            status = RACM600_VERIFY_ERROR;
+        }
+    }
+    return status;
+}
+
+// Makes sure VOUT_MODE of page is cached, reading it if not
+template <class Bus>
+bool RACM600Device<Bus>::ensureVoutMode(uint8_t page) {
+    return voutModeValid(page) || refreshVoutMode(page);
+}
+
+template <class Bus>
+bool RACM600Device<Bus>::voutModeValid(uint8_t page) const {
+    return page == RACM600_PAGE_AUX ? _auxVoutModeValid : _voutModeValid;
+}
+
+// Reads count word registers back to back on the selected page, then retries the ones that failed
+// one by one per the retry policy. Returns false if any read still failed.
+template <class Bus>
+bool RACM600Device<Bus>::readBatch(const uint8_t* commands, uint8_t count, uint16_t* raw) {
+    uint8_t width = _pec ? 3 : 2;
+    uint8_t buffer[RACM600_MAX_BATCH * 3];
+    if (count > RACM600_MAX_BATCH) {
+        return false;
+    }
+
+    uint32_t start = statsMicros();
+    bool ok[RACM600_MAX_BATCH];
+    _bus.readRegisters(_address, commands, count, buffer, width, ok);
+    _wireBytes += count * (3 + width);   // Address, command, repeated start address, data
+    uint32_t share = (statsMicros() - start) / count;   // Timed as one batch
+
+    bool complete = true;
+    uint8_t* data = buffer;
+    for (uint8_t i = 0; i < count; i++, data += width) {
+        RACM600Status status = ok[i] ? RACM600_OK : RACM600_BUS_ERROR;   // A failed read has no PEC to check
+        if (ok[i] && _pec && data[2] != readPec(commands[i], data, 2)) {
+            _pecErrors++;
+            status = RACM600_PEC_ERROR;
+        }
+        statsRecord(commands[i], share, 3 + width, status == RACM600_OK);
+        if (status != RACM600_OK && retryRead(commands[i], data, 2, status) != RACM600_OK) {
+            data[0] = 0;
+            data[1] = 0;
+            complete = false;
+        }
+        raw[i] = (data[1] << 8) | data[0];
+    }
+    return complete;
+}
+
+// Queues a non-blocking word read, returns false if a read is already in flight
+template <class Bus>
+bool RACM600Device<Bus>::beginRead(uint8_t cmd) {
+    if (_pollState != POLL_IDLE && _pollState != POLL_READY) {
+        return false;
+    }
+    _pollCommand = cmd;
+    _pollSucceeded = false;
+    _pollState = POLL_WRITE;
+    return true;
+}
+
+// Advances the queued read by one I2C phase, returns true once the result is ready
+template <class Bus>
+bool RACM600Device<Bus>::poll() {
+    uint32_t stepStart = _bus.micros();
+    uint8_t transactionBytes = 2;   // Address and command when the command byte is NAKed
+
+    switch (_pollState) {
+        case POLL_WRITE:
+            _pollStart = stepStart;
+            if (isPaged(_pollCommand) && !setPage(RACM600_PAGE_MAIN)) {
+                _pollState = POLL_READY;
+                break;
+            }
+            _wireBytes += 2;
+            // A NAK on the command byte ends the transaction early
+            _pollState = _bus.write(_address, &_pollCommand, 1, false) ? POLL_READ : POLL_READY;
+            break;
+
+        case POLL_READ:
+            _wireBytes += _pec ? 4 : 3;
+            transactionBytes += _pec ? 4 : 3;
+            if (_bus.read(_address, _pollData, _pec ? 3 : 2)) {
+                _pollSucceeded = true;
+                if (_pec && _pollData[2] != readPec(_pollCommand, _pollData, 2)) {
+                    _pecErrors++;
+                    _pollSucceeded = false;
+                }
+            }
+            _pollState = POLL_READY;
+            break;
+
+        default:
+            return _pollState == POLL_READY;
+    }
+
+    uint32_t stepEnd = _bus.micros();
+    if (stepEnd - stepStart > _pollMaxStep) {
+        _pollMaxStep = stepEnd - stepStart;
+    }
+    if (_pollState == POLL_READY) {
+        _pollLatency = stepEnd - _pollStart;
+        statsRecord(_pollCommand, _pollLatency, transactionBytes, _pollSucceeded);
+    }
+    return _pollState == POLL_READY;
+}
+
+// True when the queued read has completed, successfully or not
+template <class Bus>
+bool RACM600Device<Bus>::resultReady() const {
+    return _pollState == POLL_READY;
+}
+
+// Collects the completed read, returns false if it failed or nothing was ready
+template <class Bus>
+bool RACM600Device<Bus>::readResult(uint16_t& value) {
+    if (_pollState != POLL_READY) {
+        return false;
+    }
+    _pollState = POLL_IDLE;
+    if (!_pollSucceeded) {
+        return false;
+    }
+    value = (_pollData[1] << 8) | _pollData[0];
+    return true;
+}
+
+// Time from the first phase to the completed result of the last read, in microseconds
+template <class Bus>
+uint32_t RACM600Device<Bus>::lastTransactionMicros() const {
+    return _pollLatency;
+}
+
+// Longest time a single poll() call has blocked the caller, in microseconds
+template <class Bus>
+uint32_t RACM600Device<Bus>::maxPollStepMicros() const {
+    return _pollMaxStep;
+}
+
+// Clears the poll() timing statistics
+template <class Bus>
+void RACM600Device<Bus>::resetPollTiming() {
+    _pollLatency = 0;
+    _pollMaxStep = 0;
+}
+
+// Read Output Voltage in millivolts
+template <class Bus>
+int32_t RACM600Device<Bus>::readVoltage_mV() {
+    if (!_voutModeValid) {
+        refreshVoutMode();
+    }
+    uint16_t raw = readCommand(RACM600_READ_VOUT);
+    return RACM600Linear::decodeLinear16Scaled(raw, _voutMode, 1000);
+}
+
+// Read Output Current in milliamps
+template <class Bus>
+int32_t RACM600Device<Bus>::readCurrent_mA() {
+    return RACM600Linear::decodeLinear11Scaled(readCommand(RACM600_READ_IOUT), 1000);
+}
+
+// Read ambient temperature in hundredths of a degree Celsius
+template <class Bus>
+int32_t RACM600Device<Bus>::readAmbientTemperature_cC() {
+    return RACM600Linear::decodeLinear11Scaled(readCommand(RACM600_READ_TEMPERATURE_1), 100);
+}
+
+// Read PFC temperature in hundredths of a degree Celsius
+template <class Bus>
+int32_t RACM600Device<Bus>::readACINPUTTemperature_cC() {
+    return RACM600Linear::decodeLinear11Scaled(readCommand(RACM600_READ_TEMPERATURE_2), 100);
+}
+
+// Read LLC temperature in hundredths of a degree Celsius
+template <class Bus>
+int32_t RACM600Device<Bus>::readDCOUTPUTTemperature_cC() {
+    return RACM600Linear::decodeLinear11Scaled(readCommand(RACM600_READ_TEMPERATURE_3), 100);
+}
+
+// Read Output Power in milliwatts
+template <class Bus>
+int32_t RACM600Device<Bus>::readPower_mW() {
+    return RACM600Linear::decodeLinear11Scaled(readCommand(RACM600_READ_POUT), 1000);
+}
+
+// Read Output Voltage, volts is only written on success
+template <class Bus>
+RACM600Status RACM600Device<Bus>::tryReadVoltage(float& volts) {
+    if (!_voutModeValid) {
+        refreshVoutMode();
+    }
+    uint16_t raw;
+    RACM600Status status = tryReadWord(RACM600_READ_VOUT, raw);
+    if (status == RACM600_OK) {
+        volts = raw * _voutScale;
+    }
+    return status;
+}
+
+// Read Output Current, amps is only written on success
+template <class Bus>
+RACM600Status RACM600Device<Bus>::tryReadCurrent(float& amps) {
+    uint16_t raw;
+    RACM600Status status = tryReadWord(RACM600_READ_IOUT, raw);
+    if (status == RACM600_OK) {
+        amps = RACM600Linear::decodeLinear11(raw);
+    }
+    return status;
+}
+
+// Read Temperature sensor 1 (Ambient), 2 (PFC) or 3 (LLC), celsius is only written on success
+template <class Bus>
+RACM600Status RACM600Device<Bus>::tryReadTemperature(uint8_t sensor, float& celsius) {
+    if (sensor < 1 || sensor > 3) {
+        _lastStatus = RACM600_INVALID;
+        return RACM600_INVALID;
+    }
+    uint16_t raw;
+    RACM600Status status = tryReadWord(RACM600_READ_TEMPERATURE_1 + sensor - 1, raw);
+    if (status == RACM600_OK) {
+        celsius = RACM600Linear::decodeLinear11(raw);
+    }
+    return status;
+}
+
+// Read Output Voltage in millivolts, millivolts is only written on success
+template <class Bus>
+RACM600Status RACM600Device<Bus>::tryReadVoltage_mV(int32_t& millivolts) {
+    if (!_voutModeValid) {
+        refreshVoutMode();
+    }
+    uint16_t raw;
+    RACM600Status status = tryReadWord(RACM600_READ_VOUT, raw);
+    if (status == RACM600_OK) {
+        millivolts = RACM600Linear::decodeLinear16Scaled(raw, _voutMode, 1000);
+    }
+    return status;
+}
+
+// Read Output Current in milliamps, milliamps is only written on success
+template <class Bus>
+RACM600Status RACM600Device<Bus>::tryReadCurrent_mA(int32_t& milliamps) {
+    uint16_t raw;
+    RACM600Status status = tryReadWord(RACM600_READ_IOUT, raw);
+    if (status == RACM600_OK) {
+        milliamps = RACM600Linear::decodeLinear11Scaled(raw, 1000);
+    }
+    return status;
+}
+
+// Read Output Power, watts is only written on success
+template <class Bus>
+RACM600Status RACM600Device<Bus>::tryReadPower(float& watts) {
+    uint16_t raw;
+    RACM600Status status = tryReadWord(RACM600_READ_POUT, raw);
+    if (status == RACM600_OK) {
+        watts = RACM600Linear::decodeLinear11(raw);
+    }
+    return status;
+}
+
+// Read Output Power in milliwatts, milliwatts is only written on success
+template <class Bus>
+RACM600Status RACM600Device<Bus>::tryReadPower_mW(int32_t& milliwatts) {
+    uint16_t raw;
+    RACM600Status status = tryReadWord(RACM600_READ_POUT, raw);
+    if (status == RACM600_OK) {
+        milliwatts = RACM600Linear::decodeLinear11Scaled(raw, 1000);
+    }
+    return status;
+}
+
+// Outcome of the last register read, after any retries
+template <class Bus>
+RACM600Status RACM600Device<Bus>::lastStatus() const {
+    return _lastStatus;
+}
+
+template <class Bus>
+void RACM600Device<Bus>::setRetryPolicy(uint8_t retries, uint16_t backoffMicros) {
+    _retryLimit = retries;
+    _retryBackoff = backoffMicros;
+}
+
+template <class Bus>
+uint8_t RACM600Device<Bus>::retryLimit() const {
+    return _retryLimit;
+}
+
+template <class Bus>
+uint16_t RACM600Device<Bus>::retryBackoff() const {
+    return _retryBackoff;
+}
+
+// Retries performed by this instance since construction
+template <class Bus>
+uint32_t RACM600Device<Bus>::retries() const {
+    return _retries;
+}
+
+// Reads STATUS_WORD and only the detail registers it flags, without printing anything
+template <class Bus>
+uint16_t RACM600Device<Bus>::readFaults() {
+    FaultReport report;
+    return readFaults(report);
+}
+
+// Reads STATUS_WORD into report. Detail registers are only read when their summary bit
+// newly set, a latched fault reuses the cached detail byte and costs no extra bus traffic.
+template <class Bus>
+uint16_t RACM600Device<Bus>::readFaults(FaultReport& report) {
+    tryReadFaults(report);
+    return report.statusWord;
+}
+
+// Reads STATUS_WORD and the detail registers behind summary bits that changed. If STATUS_WORD
+// cannot be read, report is the previous report with nothing changed. A detail register that
+// cannot be read reports 0 and is read again on the next call. Returns the first failure.
+template <class Bus>
+RACM600Status RACM600Device<Bus>::tryReadFaults(FaultReport& report) {
+    uint16_t statusWord;
+    RACM600Status status = tryReadWord(RACM600_STATUS_WORD, statusWord);
+    if (status != RACM600_OK) {
+        report = _faultsValid ? _faults : FaultReport();
+        report.changed = 0;
+        return status;
+    }
+
+    report.statusWord = statusWord;
+    report.changed = _faultsValid ? (statusWord ^ _faults.statusWord) : statusWord;
+    uint16_t reread = report.changed | _faultsUnread;
+    _faultsUnread = 0;
+
+    for (uint8_t i = 0; i < RACM600_FAULT_DETAILS; i++) {
+        uint16_t mask = FAULT_DETAIL_REGISTERS[i].summaryMask;
+        uint8_t detail = 0;
+        if (statusWord & mask) {
+            if (reread & mask) {
+                RACM600Status detailStatus = tryReadByte(FAULT_DETAIL_REGISTERS[i].cmd, detail);
+                if (detailStatus != RACM600_OK) {
+                    detail = 0;
+                    _faultsUnread |= mask;
+                    if (status == RACM600_OK) status = detailStatus;
+                }
+            } else {
+                detail = _faults.detail[i];
+            }
+        }
+        report.detail[i] = detail;
+    }
+
+    _faults = report;
+    _faultsValid = true;
+    return status;
+}
+
+// Fast health check: reads the 1 byte STATUS_BYTE and only escalates to STATUS_WORD and
+// the detail registers when something is set. A healthy supply costs a single byte read.
+template <class Bus>
+uint16_t RACM600Device<Bus>::checkHealth(FaultReport& report) {
+    uint32_t startBytes = _wireBytes;
+    uint8_t statusByte;
+
+    if (tryReadByte(RACM600_STATUS_BYTE, statusByte) == RACM600_OK && statusByte == 0) {
+        // STATUS_BYTE bit 0 flags anything outside its low byte, so 0 means STATUS_WORD is clear too
+        report.statusWord = 0;
+        report.changed = _faultsValid ? _faults.statusWord : 0;
+        for (uint8_t i = 0; i < RACM600_FAULT_DETAILS; i++) {
+            report.detail[i] = 0;
+        }
+        _faults = report;
+        _faultsValid = true;
+        _faultsUnread = 0;
+    } else {
+        readFaults(report);
+    }
+
+    _lastHealthCheckBytes = _wireBytes - startBytes;
+    return report.statusWord;
+}
+
+// Bytes put on the wire by the last checkHealth(), including address bytes
+template <class Bus>
+uint8_t RACM600Device<Bus>::lastHealthCheckBytes() const {
+    return _lastHealthCheckBytes;
+}
+
+// Bytes put on the wire by this instance since construction, including address bytes
+template <class Bus>
+uint32_t RACM600Device<Bus>::wireBytes() const {
+    return _wireBytes;
+}
+
+// Reads the Alert Response Address, returns the 7 bit address of the alerting device or 0 if none answered.
+// When several devices alert at once the lowest address wins arbitration and releases SMBALERT#.
+template <class Bus>
+uint8_t RACM600Device<Bus>::readAlertResponse() {
+    uint8_t response;
+    if (!_bus.read(RACM600_ALERT_RESPONSE_ADDR, &response, 1)) {
+        return 0;
+    }
+    return response >> 1;   // Address is returned in bits 7:1
+}
+
+#ifdef ARDUINO
+// Takes one queued SMBALERT# event, or a line still held low, and reads the faults behind it.
+// The ARA read releases SMBALERT#, so the next fault raises a new edge. Returns false if no
+// alert was pending.
+template <class Bus>
+bool RACM600Device<Bus>::serviceAlert(FaultReport& report) {
+    RACM600AlertEvent event;
+    if (!RACM600Alert::pop(event) && !RACM600Alert::asserted()) {
+        return false;
+    }
+    readAlertResponse();
+    readFaults(report);
+    return true;
+}
+
+// Services SMBALERT# for several supplies sharing one line. A single ARA transaction identifies
+// the alerting supply, whose faults are then read into report. Returns the supply serviced, or
+// NULL when no alert is pending. Call repeatedly until NULL to service every alerting supply.
+template <class Bus>
+RACM600Device<Bus>* RACM600Device<Bus>::serviceAlert(RACM600Device* const devices[], uint8_t count, FaultReport& report) {
+    RACM600AlertEvent event;
+    if (!RACM600Alert::pop(event) && !RACM600Alert::asserted()) {
+        return NULL;
+    }
+
+    uint8_t address = count > 0 ? devices[0]->readAlertResponse() : 0;
+    if (address == 0) {
+        return NULL;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (devices[i]->_address == address) {
+            devices[i]->readFaults(report);
+            return devices[i];
+        }
+    }
+    return NULL;
+}
+#endif
+
+// 7 bit I2C address of this supply
+template <class Bus>
+uint8_t RACM600Device<Bus>::address() const {
+    return _address;
+}
+
+// Transport this supply is reached through
+template <class Bus>
+Bus& RACM600Device<Bus>::bus() {
+    return _bus;
+}
+
+// Forgets the cached fault state so the next readFaults() re-reads every flagged detail register
+template <class Bus>
+void RACM600Device<Bus>::resetFaultCache() {
+    _faultsValid = false;
+    _faultsUnread = 0;
+}
+
+#endif
@@ -0,0 +1,154 @@
+/**
+ *   @file RACM600Linear.h
+ *
+ *  PMBus LINEAR11 / LINEAR16 encoding and decoding shared by every read and
+ *  write path of the RACM600 library.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this 
+ *  code to support the exploration and documentation of deep-water 
+ *  ecosystems, contributing to their conservation and management. To 
+ *  sustain our mission and initiatives, please consider donating at 
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+
+#ifndef RACM600_LINEAR_H
+#define RACM600_LINEAR_H
+
+#include "RACM600Platform.h"
+
+// 2^exponent for every 5 bit exponent field, indexed by the raw field value:
+// 0..15 hold 2^0..2^15 and 16..31 hold 2^-16..2^-1. Generated at compile time.
+extern const float RACM600_LINEAR_SCALE[32] PROGMEM;
+
+/*
+ * LINEAR11 words carry a 5 bit two's complement exponent in bits 15:11 and an
+ * 11 bit two's complement mantissa in bits 10:0, value = mantissa * 2^exponent.
+ * LINEAR16 words are an unsigned mantissa whose exponent lives in bits 4:0 of VOUT_MODE.
+ */
+class RACM600Linear {
+public:
+    // Compile time 2^exponent, used to build RACM600_LINEAR_SCALE
+    static constexpr float pow2(int8_t exponent) {
+        return exponent < 0 ? 1.0f / pow2(-exponent)
+             : exponent == 0 ? 1.0f
+             : 2.0f * pow2(exponent - 1);
+    }
+
+    // Compile time scale for a raw 5 bit exponent field
+    static constexpr float fieldScale(uint8_t field) {
+        return pow2(field < 16 ? (int8_t)field : (int8_t)(field - 32));
+    }
+
+    // Sign extended exponent of a LINEAR11 word
+    static inline int8_t exponent11(uint16_t raw) {
+        return (int8_t)(raw >> 8) >> 3;
+    }
+
+    // Sign extended mantissa of a LINEAR11 word
+    static inline int16_t mantissa11(uint16_t raw) {
+        return (int16_t)(raw << 5) >> 5;
+    }
+
+    // Sign extended exponent held in a VOUT_MODE byte
+    static inline int8_t voutExponent(uint8_t voutMode) {
+        return (int8_t)(voutMode << 3) >> 3;
+    }
+
+    // Scale a raw 5 bit exponent field stands for
+    static inline float scale(uint8_t field) {
+        return pgm_read_float(&RACM600_LINEAR_SCALE[field & 0x1F]);
+    }
+
+    static inline float decodeLinear11(uint16_t raw) {
+        return mantissa11(raw) * scale(raw >> 11);
+    }
+
+    static inline float decodeLinear16(uint16_t raw, uint8_t voutMode) {
+        return raw * scale(voutMode);
+    }
+
+    // Encodes value with the smallest exponent whose mantissa still fits in 11 bits
+    static inline uint16_t encodeLinear11(float value) {
+        int8_t exponent = -16;
+        float mantissa = value * 65536.0f;
+        while ((mantissa >= 1023.5f || mantissa < -1024.5f) && exponent < 15) {
+            mantissa *= 0.5f;
+            exponent++;
+        }
+        int16_t rounded = (int16_t)(mantissa < 0 ? mantissa - 0.5f : mantissa + 0.5f);
+        if (rounded > 1023) rounded = 1023;
+        if (rounded < -1024) rounded = -1024;
+        return ((uint16_t)(exponent & 0x1F) << 11) | ((uint16_t)rounded & 0x7FF);
+    }
+
+    // Encodes value / unit (unit 1000 for milli, 100 for centi) as LINEAR11 with the smallest
+    // exponent whose mantissa still fits in 11 bits, integer math only
+    static inline uint16_t encodeLinear11Scaled(int32_t value, int32_t unit) {
+        int8_t exponent = -16;
+        int64_t mantissa = divideRounded(value, unit, exponent);
+        while ((mantissa > 1023 || mantissa < -1024) && exponent < 15) {
+            mantissa = divideRounded(value, unit, ++exponent);
+        }
+        if (mantissa > 1023) mantissa = 1023;
+        if (mantissa < -1024) mantissa = -1024;
+        return ((uint16_t)(exponent & 0x1F) << 11) | ((uint16_t)mantissa & 0x7FF);
+    }
+
+    // Encodes value / unit as a LINEAR16 mantissa for the exponent in voutMode, integer math only
+    static inline uint16_t encodeLinear16Scaled(int32_t value, uint8_t voutMode, int32_t unit) {
+        int64_t mantissa = divideRounded(value, unit, voutExponent(voutMode));
+        if (mantissa > 0xFFFF) return 0xFFFF;
+        if (mantissa < 0) return 0;
+        return (uint16_t)mantissa;
+    }
+
+    // value / unit / 2^exponent, rounded to the nearest integer (halves away from zero)
+    static inline int64_t divideRounded(int32_t value, int32_t unit, int8_t exponent) {
+        int64_t numerator = (int64_t)value * ((int64_t)1 << (exponent < 0 ? -exponent : 0));
+        int64_t denominator = (int64_t)unit << (exponent > 0 ? exponent : 0);
+        int64_t half = denominator / 2;
+        return (numerator + (numerator < 0 ? -half : half)) / denominator;
+    }
+
+    // Decodes a LINEAR11 word to value * unit (1000 for milli, 100 for centi), integer math only.
+    // Values beyond the int32_t range saturate.
+    static inline int32_t decodeLinear11Scaled(uint16_t raw, int32_t unit) {
+        return shiftRounded((int64_t)mantissa11(raw) * unit, exponent11(raw));
+    }
+
+    // Decodes a LINEAR16 word to value * unit, integer math only. Values beyond the int32_t
+    // range saturate.
+    static inline int32_t decodeLinear16Scaled(uint16_t raw, uint8_t voutMode, int32_t unit) {
+        return shiftRounded((int64_t)raw * unit, voutExponent(voutMode));
+    }
+
+    // value * 2^exponent, rounded to the nearest integer (halves away from zero, as divideRounded())
+    // and saturated to the int32_t range
+    static inline int32_t shiftRounded(int64_t value, int8_t exponent) {
+        if (exponent < 0) {
+            int64_t half = (int64_t)1 << (-exponent - 1);
+            value = value < 0 ? -((half - value) >> -exponent) : (value + half) >> -exponent;
+        } else if (value > (INT32_LIMIT >> exponent)) {
+            return INT32_LIMIT;
+        } else if (value < -(INT32_LIMIT >> exponent) - 1) {
+            return -INT32_LIMIT - 1;
+        } else {
+            value *= (int64_t)1 << exponent;
+        }
+        if (value > INT32_LIMIT) return INT32_LIMIT;
+        if (value < -INT32_LIMIT - 1) return -INT32_LIMIT - 1;
+        return (int32_t)value;
+    }
+
+private:
+    // Largest int32_t, spelled out since avr-libc only defines INT32_MAX for C++ on request
+    static const int64_t INT32_LIMIT = 2147483647;
+};
+
+#endif
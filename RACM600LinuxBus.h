@@ -0,0 +1,205 @@
+/**
+ *   @file RACM600LinuxBus.h
+ *
+ *  Linux i2c-dev transport for the RACM600 library. Every command/read pair
+ *  is a single I2C_RDWR ioctl with a repeated start, and a whole snapshot is
+ *  packed into as few ioctl calls as the kernel's message limit allows.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this 
+ *  code to support the exploration and documentation of deep-water 
+ *  ecosystems, contributing to their conservation and management. To 
+ *  sustain our mission and initiatives, please consider donating at 
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+
+#ifndef RACM600_LINUX_BUS_H
+#define RACM600_LINUX_BUS_H
+
+#ifdef __linux__
+
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+#include "RACM600.h"
+
+#ifndef RACM600_LINUX_BUFFER_SIZE
+#define RACM600_LINUX_BUFFER_SIZE 64  // Bytes of queued write data awaiting a repeated start
+#endif
+
+#ifndef RACM600_LINUX_IOCTL
+#define RACM600_LINUX_IOCTL ioctl     // Define to another function to run without an adapter
+#endif
+
+/*
+ * One /dev/i2c-N adapter. Writes made without a STOP are queued and go out in the same
+ * I2C_RDWR call as the transfer that follows them, so a write/read pair or a whole
+ * PMBus Group Command is one ioctl with one STOP, exactly as on the wire.
+ */
+class RACM600LinuxI2C {
+public:
+    RACM600LinuxI2C() : _fd(-1), _messageCount(0), _bufferUsed(0), _ioctls(0) {}
+    ~RACM600LinuxI2C() { close(); }
+
+    // Opens an adapter such as "/dev/i2c-1", returns false if it cannot be opened
+    bool open(const char* path) {
+        close();
+        _fd = ::open(path, O_RDWR);
+        return _fd >= 0;
+    }
+
+    void close() {
+        if (_fd >= 0) {
+            ::close(_fd);
+            _fd = -1;
+        }
+        _messageCount = 0;
+        _bufferUsed = 0;
+    }
+
+    bool isOpen() const { return _fd >= 0; }
+
+    // Number of ioctl calls issued, for measuring syscalls per sample
+    uint32_t ioctls() const { return _ioctls; }
+
+    // Queues a write. With stop = true the queue is sent immediately.
+    bool write(uint8_t address, const uint8_t* data, uint8_t length, bool stop) {
+        if (_messageCount == I2C_RDWR_IOCTL_MAX_MSGS || _bufferUsed + length > RACM600_LINUX_BUFFER_SIZE) {
+            if (!flush()) return false;     // Queue full, the held bus cannot be kept any longer
+        }
+        memcpy(&_buffer[_bufferUsed], data, length);
+        queue(address, 0, &_buffer[_bufferUsed], length);
+        _bufferUsed += length;
+        return stop ? flush() : true;
+    }
+
+    // Reads after any queued writes, in the same ioctl
+    bool read(uint8_t address, uint8_t* data, uint8_t length) {
+        if (_messageCount == I2C_RDWR_IOCTL_MAX_MSGS && !flush()) {
+            return false;
+        }
+        queue(address, I2C_M_RD, data, length);
+        return flush();
+    }
+
+    // count command/read pairs, 21 per ioctl with the kernel's 42 message limit. A failed
+    // ioctl fails every register it carried.
+    bool readRegisters(uint8_t address, const uint8_t* commands, uint8_t count, uint8_t* data, uint8_t length, bool* ok) {
+        if (_messageCount > 0 && !flush()) {
+            memset(data, 0, count * length);
+            memset(ok, 0, count * sizeof(bool));
+            return false;
+        }
+
+        bool complete = true;
+        for (uint8_t i = 0; i < count; i++) {
+            queue(address, 0, const_cast<uint8_t*>(&commands[i]), 1);
+            queue(address, I2C_M_RD, &data[i * length], length);
+            if (_messageCount + 2 > I2C_RDWR_IOCTL_MAX_MSGS || i + 1 == count) {
+                uint8_t first = i + 1 - _messageCount / 2;
+                bool sent = flush();
+                for (uint8_t j = first; j <= i; j++) {
+                    ok[j] = sent;
+                }
+                if (!sent) {
+                    memset(&data[first * length], 0, (i + 1 - first) * length);
+                    complete = false;
+                }
+            }
+        }
+        return complete;
+    }
+
+private:
+    void queue(uint8_t address, uint16_t flags, uint8_t* data, uint8_t length) {
+        struct i2c_msg& message = _messages[_messageCount++];
+        message.addr = address;
+        message.flags = flags;
+        message.len = length;
+        message.buf = data;
+    }
+
+    // Sends every queued message as one combined transfer ending in a single STOP
+    bool flush() {
+        if (_messageCount == 0) {
+            return true;
+        }
+        struct i2c_rdwr_ioctl_data transfer;
+        transfer.msgs = _messages;
+        transfer.nmsgs = _messageCount;
+        bool sent = _fd >= 0 && RACM600_LINUX_IOCTL(_fd, I2C_RDWR, &transfer) >= 0;
+        _ioctls++;
+        _messageCount = 0;
+        _bufferUsed = 0;
+        return sent;
+    }
+
+    // Not copyable, devices share an adapter through RACM600LinuxBus handles
+    RACM600LinuxI2C(const RACM600LinuxI2C&);
+    RACM600LinuxI2C& operator=(const RACM600LinuxI2C&);
+
+    int _fd;
+    struct i2c_msg _messages[I2C_RDWR_IOCTL_MAX_MSGS];
+    uint8_t _messageCount;
+    uint8_t _buffer[RACM600_LINUX_BUFFER_SIZE];
+    uint8_t _bufferUsed;
+    uint32_t _ioctls;
+};
+
+/*
+ * Bus handle for RACM600Device over a RACM600LinuxI2C adapter:
+ *
+ *   RACM600LinuxI2C adapter;
+ *   adapter.open("/dev/i2c-1");
+ *   RACM600Device<RACM600LinuxBus> psu(0x27, RACM600LinuxBus(adapter));
+ */
+class RACM600LinuxBus {
+public:
+    RACM600LinuxBus() : _adapter(NULL) {}
+    RACM600LinuxBus(RACM600LinuxI2C& adapter) : _adapter(&adapter) {}
+
+    void begin() {}
+
+    bool write(uint8_t address, const uint8_t* data, uint8_t length, bool stop = true) {
+        return _adapter->write(address, data, length, stop);
+    }
+
+    bool read(uint8_t address, uint8_t* data, uint8_t length) {
+        return _adapter->read(address, data, length);
+    }
+
+    bool writeRead(uint8_t address, const uint8_t* out, uint8_t outLength, uint8_t* in, uint8_t inLength) {
+        return _adapter->write(address, out, outLength, false) && _adapter->read(address, in, inLength);
+    }
+
+    bool readRegisters(uint8_t address, const uint8_t* commands, uint8_t count, uint8_t* data, uint8_t length, bool* ok) {
+        return _adapter->readRegisters(address, commands, count, data, length, ok);
+    }
+
+    uint32_t micros() const {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (uint32_t)now.tv_sec * 1000000UL + now.tv_nsec / 1000;
+    }
+
+    void delayMicros(uint32_t micros) {
+        usleep(micros);
+    }
+
+private:
+    RACM600LinuxI2C* _adapter;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,205 @@
+/**
+ *   @file RACM600Log.h
+ *
+ *  Compact binary telemetry log for the RACM600 library: snapshots are encoded
+ *  as keyframes of raw register words followed by zigzag varint deltas, for
+ *  uplinks that move only a few hundred bits per second. The decoder has no
+ *  Arduino dependencies and builds on the receiving host as is.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this
+ *  code to support the exploration and documentation of deep-water
+ *  ecosystems, contributing to their conservation and management. To
+ *  sustain our mission and initiatives, please consider donating at
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+
+#ifndef RACM600_LOG_H
+#define RACM600_LOG_H
+
+#include "RACM600.h"
+
+#define RACM600_LOG_MAX_RECORD 34           // Largest record: 2 byte header, 5 byte time, 9 3-byte deltas
+#define RACM600_LOG_KEYFRAME_INTERVAL 64    // Default records between keyframes
+
+/*
+ * Stream layout, one record per snapshot. Every field is little endian.
+ *
+ *   header   varint   (channel mask << 1) | keyframe
+ *
+ *   keyframe: timestamp  varint   micros
+ *             voutMode   byte
+ *             raw        2 bytes  per channel, all RACM600_SNAPSHOT_CHANNELS of them
+ *
+ *   delta:    elapsed    varint   micros since the previous record
+ *             delta      varint   zigzag of (raw - previous raw) mod 2^16, per channel set in the mask
+ *
+ * A keyframe is written first, every keyframe interval records after that, and whenever
+ * VOUT_MODE changes, so a receiver that lost data resynchronizes at the next keyframe.
+ */
+class RACM600LogFormat {
+public:
+    static uint8_t* putVarint(uint8_t* out, uint32_t value) {
+        while (value >= 0x80) {
+            *out++ = (value & 0x7F) | 0x80;
+            value >>= 7;
+        }
+        *out++ = value;
+        return out;
+    }
+
+    // Returns the bytes consumed, 0 if the varint is truncated or longer than 5 bytes
+    static uint8_t getVarint(const uint8_t* in, size_t length, uint32_t& value) {
+        value = 0;
+        for (uint8_t i = 0; i < 5 && i < length; i++) {
+            value |= (uint32_t)(in[i] & 0x7F) << (7 * i);
+            if ((in[i] & 0x80) == 0) {
+                return i + 1;
+            }
+        }
+        return 0;
+    }
+
+    // Maps small signed deltas to small unsigned values: 0, -1, 1, -2, 2 ... to 0, 1, 2, 3, 4 ...
+    static uint16_t zigzag(int16_t delta) {
+        return ((uint16_t)delta << 1) ^ (uint16_t)(delta >> 15);
+    }
+
+    static int16_t unzigzag(uint16_t value) {
+        return (int16_t)((value >> 1) ^ (0 - (value & 1)));
+    }
+};
+
+// Encodes successive snapshots into the stream described above
+class RACM600LogEncoder {
+public:
+    RACM600LogEncoder(uint16_t keyframeInterval = RACM600_LOG_KEYFRAME_INTERVAL)
+        : _previous(), _keyframeInterval(keyframeInterval) {
+        reset();
+    }
+
+    // Makes the next record a keyframe, e.g. after a transmission was lost
+    void reset() {
+        _sinceKeyframe = 0;
+        _primed = false;
+    }
+
+    void setKeyframeInterval(uint16_t records) { _keyframeInterval = records; }
+    uint16_t keyframeInterval() const { return _keyframeInterval; }
+
+    // Writes one record to out, which must hold RACM600_LOG_MAX_RECORD bytes. Returns its length.
+    size_t encode(const RACM600Snapshot& snapshot, uint8_t* out) {
+        uint8_t* start = out;
+
+        if (!_primed || snapshot.voutMode != _previous.voutMode || _sinceKeyframe >= _keyframeInterval) {
+            out = RACM600LogFormat::putVarint(out, (((1UL << RACM600_SNAPSHOT_CHANNELS) - 1) << 1) | 1);
+            out = RACM600LogFormat::putVarint(out, snapshot.timestamp);
+            *out++ = snapshot.voutMode;
+            for (uint8_t i = 0; i < RACM600_SNAPSHOT_CHANNELS; i++) {
+                uint16_t raw = snapshot.raw[i];
+                *out++ = lowByte(raw);
+                *out++ = highByte(raw);
+            }
+            _sinceKeyframe = 1;
+            _primed = true;
+        } else {
+            uint16_t mask = 0;
+            for (uint8_t i = 0; i < RACM600_SNAPSHOT_CHANNELS; i++) {
+                if (snapshot.raw[i] != _previous.raw[i]) {
+                    mask |= 1 << i;
+                }
+            }
+            out = RACM600LogFormat::putVarint(out, (uint32_t)mask << 1);
+            out = RACM600LogFormat::putVarint(out, snapshot.timestamp - _previous.timestamp);
+            for (uint8_t i = 0; i < RACM600_SNAPSHOT_CHANNELS; i++) {
+                if (mask & (1 << i)) {
+                    int16_t delta = (int16_t)(snapshot.raw[i] - _previous.raw[i]);
+                    out = RACM600LogFormat::putVarint(out, RACM600LogFormat::zigzag(delta));
+                }
+            }
+            _sinceKeyframe++;
+        }
+
+        _previous = snapshot;
+        return out - start;
+    }
+
+private:
+    RACM600Snapshot _previous;
+    uint16_t _keyframeInterval;
+    uint16_t _sinceKeyframe;
+    bool _primed;
+};
+
+// Rebuilds snapshots from the stream, bit for bit
+class RACM600LogDecoder {
+public:
+    RACM600LogDecoder() { reset(); }
+
+    // Drops the decoding state, records are skipped until the next keyframe
+    void reset() {
+        _previous = RACM600Snapshot();
+        _primed = false;
+        _waiting = false;
+    }
+
+    // Decodes the record at the start of in into snapshot. Returns the bytes consumed, 0 if in
+    // holds no complete record or the record is malformed. A delta record arriving before any
+    // keyframe is consumed without producing a snapshot; waiting() reports that case.
+    size_t decode(const uint8_t* in, size_t length, RACM600Snapshot& snapshot) {
+        const uint8_t* start = in;
+        const uint8_t* end = in + length;
+        uint32_t header;
+        uint32_t value;
+        uint8_t used;
+
+        if ((used = RACM600LogFormat::getVarint(in, end - in, header)) == 0) return 0;
+        in += used;
+        if ((used = RACM600LogFormat::getVarint(in, end - in, value)) == 0) return 0;
+        in += used;
+        uint16_t mask = header >> 1;
+        if (mask >> RACM600_SNAPSHOT_CHANNELS) return 0;
+
+        RACM600Snapshot next = _previous;
+        if (header & 1) {
+            if ((size_t)(end - in) < 1 + 2 * RACM600_SNAPSHOT_CHANNELS) return 0;
+            next.timestamp = value;
+            next.voutMode = *in++;
+            for (uint8_t i = 0; i < RACM600_SNAPSHOT_CHANNELS; i++, in += 2) {
+                next.raw[i] = in[0] | (in[1] << 8);
+            }
+        } else {
+            next.timestamp += value;
+            for (uint8_t i = 0; i < RACM600_SNAPSHOT_CHANNELS; i++) {
+                if (mask & (1 << i)) {
+                    if ((used = RACM600LogFormat::getVarint(in, end - in, value)) == 0 || value > 0xFFFF) return 0;
+                    in += used;
+                    next.raw[i] = next.raw[i] + RACM600LogFormat::unzigzag(value);
+                }
+            }
+        }
+
+        _waiting = !(header & 1) && !_primed;
+        if (!_waiting) {
+            _previous = next;
+            _primed = true;
+            snapshot = next;
+        }
+        return in - start;
+    }
+
+    // True if the last decode() skipped a delta record because no keyframe had been seen yet
+    bool waiting() const { return _waiting; }
+
+private:
+    RACM600Snapshot _previous;
+    bool _primed;
+    bool _waiting;
+};
+
+#endif
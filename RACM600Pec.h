@@ -0,0 +1,65 @@
+/**
+ *   @file RACM600Pec.h
+ *
+ *  SMBus Packet Error Checking (CRC-8, polynomial x^8 + x^2 + x + 1) for the
+ *  RACM600 library.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this 
+ *  code to support the exploration and documentation of deep-water 
+ *  ecosystems, contributing to their conservation and management. To 
+ *  sustain our mission and initiatives, please consider donating at 
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+
+#ifndef RACM600_PEC_H
+#define RACM600_PEC_H
+
+#include "RACM600Platform.h"
+
+// Define RACM600_PEC_BITWISE to compute the CRC bit by bit instead of from the
+// 256 byte lookup table, trading speed for flash on constrained targets.
+#ifndef RACM600_PEC_BITWISE
+// CRC-8 of every byte value, generated at compile time
+extern const uint8_t RACM600_CRC8_TABLE[256] PROGMEM;
+#endif
+
+class RACM600Pec {
+public:
+    // One shift of the CRC register
+    static constexpr uint8_t step(uint8_t crc) {
+        return (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+
+    // CRC-8 of a single byte, used to build RACM600_CRC8_TABLE
+    static constexpr uint8_t entry(uint8_t value, uint8_t bits = 8) {
+        return bits == 0 ? value : entry(step(value), bits - 1);
+    }
+
+    // Folds one byte into a running PEC, start from 0
+    static inline uint8_t update(uint8_t crc, uint8_t data) {
+#ifdef RACM600_PEC_BITWISE
+        crc ^= data;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = step(crc);
+        }
+        return crc;
+#else
+        return pgm_read_byte(&RACM600_CRC8_TABLE[crc ^ data]);
+#endif
+    }
+
+    static inline uint8_t update(uint8_t crc, const uint8_t* data, uint8_t length) {
+        for (uint8_t i = 0; i < length; i++) {
+            crc = update(crc, data[i]);
+        }
+        return crc;
+    }
+};
+
+#endif
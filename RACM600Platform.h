@@ -0,0 +1,39 @@
+/**
+ *   @file RACM600Platform.h
+ *
+ *  Platform glue for the RACM600 library. On Arduino this is just Arduino.h,
+ *  elsewhere (Linux hosts) it supplies the few Arduino definitions the
+ *  portable parts of the library rely on.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this 
+ *  code to support the exploration and documentation of deep-water 
+ *  ecosystems, contributing to their conservation and management. To 
+ *  sustain our mission and initiatives, please consider donating at 
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+
+#ifndef RACM600_PLATFORM_H
+#define RACM600_PLATFORM_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stddef.h>
+
+// Tables live in ordinary memory on hosts without a separate program space
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_float(address) (*(const float*)(address))
+
+#define lowByte(w) ((uint8_t)((w) & 0xFF))
+#define highByte(w) ((uint8_t)((w) >> 8))
+#endif
+
+#endif
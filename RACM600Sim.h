@@ -0,0 +1,654 @@
+/**
+ *   @file RACM600Sim.h
+ *
+ *  Simulated RACM600 PMBus devices and a simulated I2C bus for running the
+ *  RACM600 library without hardware, on a plain Linux box or any other host.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this
+ *  code to support the exploration and documentation of deep-water
+ *  ecosystems, contributing to their conservation and management. To
+ *  sustain our mission and initiatives, please consider donating at
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+
+#ifndef RACM600_SIM_H
+#define RACM600_SIM_H
+
+#include <string.h>
+
+#include "RACM600.h"
+
+#ifndef RACM600_SIM_MAX_DEVICES
+#define RACM600_SIM_MAX_DEVICES 16  // Devices one simulated bus can hold
+#endif
+
+// Bus conditions in a RACM600Simulator trace, every other entry is a byte as it crossed the bus
+#define RACM600_SIM_START       0x100
+#define RACM600_SIM_RESTART     0x101   // Repeated START
+#define RACM600_SIM_STOP        0x102
+#define RACM600_SIM_NAK         0x103   // Address byte not acknowledged
+
+/*
+ * One simulated RACM600. Registers hold the same raw LINEAR11 / LINEAR16 words the real
+ * supply returns, telemetry setters encode engineering units into them. Setting telemetry
+ * past a warning or fault limit latches the matching STATUS_* bits, like the real device.
+ *
+ * READ_VOUT, READ_IOUT, READ_POUT, READ_TEMPERATURE_3, VOUT_MODE, the output limits and
+ * STATUS_WORD, STATUS_BYTE, STATUS_VOUT and STATUS_IOUT are paged (Page 0: Main, Page 1:
+ * AUX/VSB), every other register is shared.
+ *
+ * A write is checked as it is received but only executed at the STOP that ends its
+ * transaction, as PMBus requires, so every segment of a Group Command takes effect together.
+ */
+class RACM600SimDevice {
+public:
+    RACM600SimDevice(uint8_t address = RACM600_DEFAULT_ADDR) : _address(address) {
+        reset();
+    }
+
+    // Power-on state of a 12 V RACM600 with its output on
+    void reset() {
+        memset(_registers, 0, sizeof(_registers));
+        _page = 0;
+        _command = 0;
+        _pendingLength = 0;
+        _alert = false;
+        _writes = 0;
+
+        for (uint8_t page = 0; page < 2; page++) {
+            _registers[page][RACM600_VOUT_MODE] = 0x17;     // LINEAR16, exponent -9
+            _registers[page][RACM600_OPERATION] = 0x80;
+        }
+        _registers[0][RACM600_CAPABILITY] = 0xB0;           // PEC, 400 kHz, SMBALERT#
+        _registers[0][RACM600_PMBUS_REVISION] = 0x22;       // PMBus 1.2
+
+        setLinear16(0, RACM600_VOUT_OV_FAULT_LIMIT, 14.5f);
+        setLinear11(0, RACM600_IOUT_OC_FAULT_LIMIT, 55.0f);
+        setLinear11(0, RACM600_IOUT_OC_WARN_LIMIT, 52.0f);
+        setLinear16(1, RACM600_VOUT_OV_FAULT_LIMIT, 14.5f);
+        setLinear11(1, RACM600_IOUT_OC_FAULT_LIMIT, 3.5f);
+        setLinear11(1, RACM600_IOUT_OC_WARN_LIMIT, 3.0f);
+        setLinear11(0, RACM600_OT_FAULT_LIMIT, 110.0f);
+        setLinear11(0, RACM600_OT_WARN_LIMIT, 100.0f);
+
+        setLinear11(0, RACM600_MFR_VIN_MIN, 90.0f);
+        setLinear11(0, RACM600_MFR_VIN_MAX, 264.0f);
+        setLinear11(0, RACM600_MFR_IIN_MAX, 7.5f);
+        setLinear11(0, RACM600_MFR_PIN_MAX, 680.0f);
+        setLinear16(0, RACM600_MFR_VOUT_MIN, 11.4f);
+        setLinear16(0, RACM600_MFR_VOUT_MAX, 12.6f);
+        setLinear11(0, RACM600_MFR_IOUT_MAX, 50.0f);
+        setLinear11(0, RACM600_MFR_POUT_MAX, 600.0f);
+        setLinear11(0, RACM600_MFR_TAMBIENT_MAX, 70.0f);
+        setLinear11(0, RACM600_MFR_TAMBIENT_MIN, -40.0f);
+
+        setVoltage(12.0f);
+        setVoltage(5.0f, 1);
+        setCurrent(0.0f);
+        setCurrent(0.0f, 1);
+        setInputVoltage(230.0f);
+        setCapacitorVoltage(390.0f);
+        setTemperature(1, 25.0f);
+        setTemperature(2, 30.0f);
+        setTemperature(3, 30.0f);
+        setTemperature(3, 28.0f, 1);
+    }
+
+    uint8_t address() const { return _address; }
+
+    // Telemetry in engineering units, page 0 unless given
+    void setVoltage(float volts, uint8_t page = 0) {
+        setLinear16(page, RACM600_READ_VOUT, volts);
+        updatePower(page);
+    }
+
+    void setCurrent(float amps, uint8_t page = 0) {
+        setLinear11(page, RACM600_READ_IOUT, amps);
+        updatePower(page);
+    }
+
+    void setInputVoltage(float volts) { setLinear11(0, RACM600_READ_VIN, volts); }
+    void setCapacitorVoltage(float volts) { setLinear11(0, RACM600_READ_VCAP, volts); }
+
+    // sensor is 1 (ambient), 2 (PFC) or 3 (LLC on page 0, VSB on page 1)
+    void setTemperature(uint8_t sensor, float celsius, uint8_t page = 0) {
+        setLinear11(sensor == 3 ? page : 0, RACM600_READ_TEMPERATURE_1 + sensor - 1, celsius);
+        checkLimits();
+    }
+
+    // Latches bits in a STATUS_* detail register and raises SMBALERT#. STATUS_VOUT and
+    // STATUS_IOUT are per page, the other detail registers ignore page.
+    void raiseFault(uint8_t statusCommand, uint8_t bits, uint8_t page = 0) {
+        setReg(statusCommand, reg(statusCommand, page) | bits, page);
+        _alert = true;
+    }
+
+    // Raw register access, for anything the setters do not cover
+    uint16_t reg(uint8_t cmd, uint8_t page = 0) const { return _registers[paged(cmd) ? page & 1 : 0][cmd]; }
+    void setReg(uint8_t cmd, uint16_t value, uint8_t page = 0) { _registers[paged(cmd) ? page & 1 : 0][cmd] = value; }
+
+    uint8_t page() const { return _page; }
+    bool outputOn(uint8_t page = 0) const { return (reg(RACM600_OPERATION, page) & 0x80) != 0; }
+
+    // STATUS_WORD of a page as derived from the detail registers and the output state
+    uint16_t statusWord(uint8_t page = 0) const {
+        uint16_t status = 0;
+        if (reg(RACM600_STATUS_VOUT, page)) status |= 0x8020;
+        if (reg(RACM600_STATUS_IOUT, page)) status |= 0x4010;
+        if (reg(RACM600_STATUS_INPUT)) status |= 0x2008;
+        if (reg(RACM600_STATUS_TEMPERATURE)) status |= 0x0004;
+        if (reg(RACM600_STATUS_CML)) status |= 0x0002;
+        if (reg(RACM600_STATUS_OTHER)) status |= 0x0100;
+        if (reg(RACM600_STATUS_MFR_SPECIFIC)) status |= 0x1000;
+        if (!outputOn(page)) status |= 0x0840;
+        if ((status & 0xFF00) && !(status & 0x00FE)) status |= 0x0001;   // NONE OF THE ABOVE
+        return status;
+    }
+
+    // True while the device holds SMBALERT# low
+    bool alerting() const { return _alert; }
+
+    // Register writes executed, including Send-Byte commands
+    uint32_t writes() const { return _writes; }
+
+    // True while a received write waits for the STOP of its transaction
+    bool writePending() const { return _pendingLength != 0; }
+
+    // Bus side: a write of cmd plus data. Returns false (NAK) for data of the wrong size or a bad PEC.
+    bool receive(const uint8_t* data, uint8_t length) {
+        if (length == 0) {
+            return true;
+        }
+        _command = data[0];
+        if (length == 1 && writeLength(_command) != 0) {
+            return true;    // Command byte of a read, or a write that continues after a repeated start
+        }
+
+        uint8_t expected = writeLength(_command);
+        if (length == expected + 2) {
+            uint8_t crc = RACM600Pec::update(0, _address << 1);
+            if (RACM600Pec::update(crc, data, length - 1) != data[length - 1]) {
+                raiseFault(RACM600_STATUS_CML, 0x20);   // Packet Error Check Failed
+                return false;
+            }
+        } else if (length != expected + 1) {
+            raiseFault(RACM600_STATUS_CML, 0x40);       // Invalid Data Received
+            return false;
+        }
+
+        _pendingLength = expected + 1;
+        for (uint8_t i = 0; i < _pendingLength; i++) {
+            _pending[i] = data[i];
+        }
+        return true;
+    }
+
+    // Bus side: the STOP ending a transaction, executes the write received during it if any
+    void stop() {
+        if (_pendingLength == 0) {
+            return;
+        }
+        _pendingLength = 0;
+        execute(_pending[0], &_pending[1]);
+        _writes++;
+    }
+
+    // Bus side: the read following the command byte. Bytes past the register width carry
+    // the PEC of the transaction and then 0xFF, as on the real bus.
+    void transmit(uint8_t* data, uint8_t length) {
+        uint8_t value[2];
+        uint8_t width = readWidth(_command);
+        uint16_t word = _command == RACM600_STATUS_WORD ? statusWord(_page)
+                      : _command == RACM600_STATUS_BYTE ? (statusWord(_page) & 0xFF)
+                      : _command == RACM600_PAGE ? _page
+                      : reg(_command, _page);
+        value[0] = lowByte(word);
+        value[1] = highByte(word);
+
+        uint8_t crc = RACM600Pec::update(0, _address << 1);
+        crc = RACM600Pec::update(crc, _command);
+        crc = RACM600Pec::update(crc, (_address << 1) | 1);
+        crc = RACM600Pec::update(crc, value, width);
+
+        for (uint8_t i = 0; i < length; i++) {
+            data[i] = i < width ? value[i] : (i == width ? crc : 0xFF);
+        }
+    }
+
+    // Bus side: answers an Alert Response Address read and releases SMBALERT#
+    uint8_t acknowledgeAlert() {
+        _alert = false;
+        return _address << 1;
+    }
+
+private:
+    static bool paged(uint8_t cmd) {
+        return RACM600Base::isPaged(cmd);
+    }
+
+    // Data bytes a write of cmd carries, 0xFF for read-only registers
+    static uint8_t writeLength(uint8_t cmd) {
+        switch (cmd) {
+            case RACM600_CLEAR_FAULTS:          return 0;
+            case RACM600_PAGE:
+            case RACM600_OPERATION:             return 1;
+            case RACM600_VOUT_OV_FAULT_LIMIT:
+            case RACM600_IOUT_OC_FAULT_LIMIT:
+            case RACM600_IOUT_OC_WARN_LIMIT:    return 2;
+            default:                            return 0xFF;
+        }
+    }
+
+    // Bytes a read of cmd returns before the PEC
+    static uint8_t readWidth(uint8_t cmd) {
+        switch (cmd) {
+            case RACM600_PAGE:
+            case RACM600_OPERATION:
+            case RACM600_CAPABILITY:
+            case RACM600_VOUT_MODE:
+            case RACM600_STATUS_BYTE:
+            case RACM600_STATUS_VOUT:
+            case RACM600_STATUS_IOUT:
+            case RACM600_STATUS_INPUT:
+            case RACM600_STATUS_TEMPERATURE:
+            case RACM600_STATUS_CML:
+            case RACM600_STATUS_OTHER:
+            case RACM600_STATUS_MFR_SPECIFIC:
+            case RACM600_PMBUS_REVISION:        return 1;
+            default:                            return 2;
+        }
+    }
+
+    void execute(uint8_t cmd, const uint8_t* data) {
+        switch (cmd) {
+            case RACM600_CLEAR_FAULTS:
+                for (uint8_t status = RACM600_STATUS_VOUT; status <= RACM600_STATUS_MFR_SPECIFIC; status++) {
+                    _registers[0][status] = 0;
+                    _registers[1][status] = 0;
+                }
+                _alert = false;
+                checkLimits();      // Conditions still present latch again
+                break;
+            case RACM600_PAGE:
+                _page = data[0] & 1;
+                break;
+            case RACM600_OPERATION:
+                setReg(RACM600_OPERATION, data[0], _page);
+                break;
+            default:
+                setReg(cmd, data[0] | (data[1] << 8), _page);
+                checkLimits();
+                break;
+        }
+    }
+
+    void setLinear11(uint8_t page, uint8_t cmd, float value) {
+        _registers[page & 1][cmd] = RACM600Linear::encodeLinear11(value);
+    }
+
+    void setLinear16(uint8_t page, uint8_t cmd, float value) {
+        float mantissa = value / RACM600Linear::scale(_registers[page & 1][RACM600_VOUT_MODE]);
+        _registers[page & 1][cmd] = (uint16_t)(mantissa + 0.5f);
+    }
+
+    void updatePower(uint8_t page) {
+        float volts = RACM600Linear::decodeLinear16(reg(RACM600_READ_VOUT, page), reg(RACM600_VOUT_MODE, page));
+        float amps = RACM600Linear::decodeLinear11(reg(RACM600_READ_IOUT, page));
+        setLinear11(page, RACM600_READ_POUT, volts * amps);
+        checkLimits();
+    }
+
+    // Latches warning and fault bits for telemetry past its limits
+    void checkLimits() {
+        for (uint8_t page = 0; page < 2; page++) {
+            if (reg(RACM600_READ_VOUT, page) > reg(RACM600_VOUT_OV_FAULT_LIMIT, page)) {
+                latch(RACM600_STATUS_VOUT, 0x80, page);
+            }
+            float amps = RACM600Linear::decodeLinear11(reg(RACM600_READ_IOUT, page));
+            if (amps > RACM600Linear::decodeLinear11(reg(RACM600_IOUT_OC_WARN_LIMIT, page))) {
+                latch(RACM600_STATUS_IOUT, 0x20, page);
+            }
+            if (amps > RACM600Linear::decodeLinear11(reg(RACM600_IOUT_OC_FAULT_LIMIT, page))) {
+                latch(RACM600_STATUS_IOUT, 0x80, page);
+            }
+        }
+
+        float warn = RACM600Linear::decodeLinear11(reg(RACM600_OT_WARN_LIMIT));
+        float fault = RACM600Linear::decodeLinear11(reg(RACM600_OT_FAULT_LIMIT));
+        for (uint8_t sensor = 0; sensor < 4; sensor++) {
+            uint16_t raw = sensor < 3 ? reg(RACM600_READ_TEMPERATURE_1 + sensor) : reg(RACM600_READ_TEMPERATURE_3, 1);
+            float celsius = RACM600Linear::decodeLinear11(raw);
+            if (celsius > warn) latch(RACM600_STATUS_TEMPERATURE, 0x40);
+            if (celsius > fault) latch(RACM600_STATUS_TEMPERATURE, 0x80);
+        }
+    }
+
+    void latch(uint8_t statusCommand, uint8_t bits, uint8_t page = 0) {
+        if ((reg(statusCommand, page) & bits) != bits) {
+            raiseFault(statusCommand, bits, page);
+        }
+    }
+
+    uint8_t _address;
+    uint16_t _registers[2][256];    // Raw register words per page, shared registers live in page 0
+    uint8_t _page;
+    uint8_t _command;               // Last command byte received, selects what a read returns
+    uint8_t _pending[3];            // Command and data of a write waiting for STOP
+    uint8_t _pendingLength;
+    bool _alert;
+    uint32_t _writes;
+};
+
+/*
+ * A simulated I2C bus holding RACM600SimDevice instances. Time only moves as bytes cross
+ * the bus (or through advance()), at 9 bit times per byte plus START/STOP, so bus time and
+ * throughput measured through micros() match what the real bus would spend at the chosen
+ * clock. NAKs can be injected at a given rate to exercise error handling.
+ */
+class RACM600Simulator {
+public:
+    RACM600Simulator(uint32_t clockHz = 100000)
+        : _deviceCount(0), _now(0), _nanos(0), _nakRate(0), _random(0x2545F491UL),
+          _transactions(0), _bytes(0), _naks(0), _held(false),
+          _trace(NULL), _traceCapacity(0), _traceLength(0) {
+        setClock(clockHz);
+    }
+
+    // Puts a device on the bus, returns false if the bus is full
+    bool attach(RACM600SimDevice& device) {
+        if (_deviceCount == RACM600_SIM_MAX_DEVICES) return false;
+        _devices[_deviceCount++] = &device;
+        return true;
+    }
+
+    // SCL frequency, sets the time of one byte (8 data bits and ACK) and of START/STOP
+    void setClock(uint32_t hz) {
+        _bitNanos = 1000000000UL / hz;
+    }
+
+    // Overrides the per-byte time directly, for buses with clock stretching or slow masters
+    void setByteNanos(uint32_t nanos) {
+        _bitNanos = nanos / 9;
+    }
+
+    // Probability of a transaction being NAKed, 0.0 to 1.0
+    void setNakRate(float rate) {
+        _nakRate = (uint32_t)(rate * 4294967295.0f);
+    }
+
+    // Simulated microseconds since construction
+    uint32_t micros() const { return _now; }
+
+    // Lets simulated time pass, for sketch work between bus transfers
+    void advance(uint32_t micros) { _now += micros; }
+
+    // True while any device holds SMBALERT# low
+    bool alertAsserted() const {
+        for (uint8_t i = 0; i < _deviceCount; i++) {
+            if (_devices[i]->alerting()) return true;
+        }
+        return false;
+    }
+
+    // Records every bus condition and byte into buffer from now on, NULL stops recording.
+    // Entries past capacity are dropped.
+    void setTrace(uint16_t* buffer, uint16_t capacity) {
+        _trace = buffer;
+        _traceCapacity = buffer != NULL ? capacity : 0;
+        _traceLength = 0;
+    }
+    uint16_t traceLength() const { return _traceLength; }
+
+    uint32_t transactions() const { return _transactions; }
+    uint32_t bytes() const { return _bytes; }
+    uint32_t naks() const { return _naks; }
+
+    bool write(uint8_t address, const uint8_t* data, uint8_t length, bool stop) {
+        RACM600SimDevice* device = start(address, length, false);
+        if (device != NULL) traceBytes(data, length);
+        bool acknowledged = device != NULL && device->receive(data, length);
+        finish(stop || !acknowledged);  // A NAK ends the transaction with a STOP, as the Wire master does
+        return acknowledged;
+    }
+
+    bool read(uint8_t address, uint8_t* data, uint8_t length) {
+        if (address == RACM600_ALERT_RESPONSE_ADDR) {
+            return readAlertResponse(data, length);
+        }
+        RACM600SimDevice* device = start(address, length, true);
+        if (device != NULL) {
+            device->transmit(data, length);
+            traceBytes(data, length);
+        }
+        finish(true);
+        return device != NULL;
+    }
+
+private:
+    // START (or repeated START) and address byte, returns NULL when nobody acknowledges
+    RACM600SimDevice* start(uint8_t address, uint8_t length, bool read) {
+        trace(_held ? RACM600_SIM_RESTART : RACM600_SIM_START);
+        if (!_held) _transactions++;
+        elapse(1 + 9);              // START, address byte
+        _bytes += 1;
+        trace((address << 1) | (read ? 1 : 0));
+
+        RACM600SimDevice* device = find(address);
+        if (device == NULL || injectNak()) {
+            _naks++;
+            trace(RACM600_SIM_NAK);
+            return NULL;
+        }
+        elapse(9 * length);
+        _bytes += length;
+        return device;
+    }
+
+    // Repeated START when the bus stays held, otherwise STOP, which executes pending writes
+    void finish(bool stop) {
+        _held = !stop;
+        if (!stop) {
+            return;
+        }
+        trace(RACM600_SIM_STOP);
+        elapse(1);
+        for (uint8_t i = 0; i < _deviceCount; i++) {
+            _devices[i]->stop();
+        }
+    }
+
+    // Lowest alerting address wins arbitration, as on the real bus
+    bool readAlertResponse(uint8_t* data, uint8_t length) {
+        RACM600SimDevice* winner = NULL;
+        for (uint8_t i = 0; i < _deviceCount; i++) {
+            if (_devices[i]->alerting() && (winner == NULL || _devices[i]->address() < winner->address())) {
+                winner = _devices[i];
+            }
+        }
+        trace(_held ? RACM600_SIM_RESTART : RACM600_SIM_START);
+        if (!_held) _transactions++;
+        elapse(1 + 9);
+        _bytes += 1;
+        trace((RACM600_ALERT_RESPONSE_ADDR << 1) | 1);
+        if (winner == NULL) {
+            _naks++;
+            trace(RACM600_SIM_NAK);
+            finish(true);
+            return false;
+        }
+        elapse(9 * length);
+        _bytes += length;
+        data[0] = winner->acknowledgeAlert();
+        for (uint8_t i = 1; i < length; i++) data[i] = 0xFF;
+        traceBytes(data, length);
+        finish(true);
+        return true;
+    }
+
+    RACM600SimDevice* find(uint8_t address) {
+        for (uint8_t i = 0; i < _deviceCount; i++) {
+            if (_devices[i]->address() == address) return _devices[i];
+        }
+        return NULL;
+    }
+
+    bool injectNak() {
+        if (_nakRate == 0) return false;
+        _random ^= _random << 13;   // xorshift32, deterministic from run to run
+        _random ^= _random >> 17;
+        _random ^= _random << 5;
+        return _random < _nakRate;
+    }
+
+    void trace(uint16_t entry) {
+        if (_traceLength < _traceCapacity) _trace[_traceLength++] = entry;
+    }
+
+    void traceBytes(const uint8_t* data, uint8_t length) {
+        for (uint8_t i = 0; i < length; i++) trace(data[i]);
+    }
+
+    void elapse(uint32_t bits) {
+        _nanos += bits * _bitNanos;
+        _now += _nanos / 1000;
+        _nanos %= 1000;
+    }
+
+    RACM600SimDevice* _devices[RACM600_SIM_MAX_DEVICES];
+    uint8_t _deviceCount;
+    uint32_t _bitNanos;
+    uint32_t _now;
+    uint32_t _nanos;                // Sub-microsecond remainder of _now
+    uint32_t _nakRate;
+    uint32_t _random;
+    uint32_t _transactions;
+    uint32_t _bytes;
+    uint32_t _naks;
+    bool _held;                     // Bus held for a repeated start
+    uint16_t* _trace;
+    uint16_t _traceCapacity;
+    uint16_t _traceLength;
+};
+
+/*
+ * Bus handle for RACM600Device over a RACM600Simulator:
+ *
+ *   RACM600Simulator sim(400000);
+ *   RACM600SimDevice supply(0x27);
+ *   sim.attach(supply);
+ *   RACM600Device<RACM600SimBus> psu(0x27, RACM600SimBus(sim));
+ */
+class RACM600SimBus {
+public:
+    RACM600SimBus() : _sim(NULL) {}
+    RACM600SimBus(RACM600Simulator& sim) : _sim(&sim) {}
+
+    void begin() {}
+
+    bool write(uint8_t address, const uint8_t* data, uint8_t length, bool stop = true) {
+        return _sim->write(address, data, length, stop);
+    }
+
+    bool read(uint8_t address, uint8_t* data, uint8_t length) {
+        return _sim->read(address, data, length);
+    }
+
+    bool writeRead(uint8_t address, const uint8_t* out, uint8_t outLength, uint8_t* in, uint8_t inLength) {
+        return _sim->write(address, out, outLength, false) && _sim->read(address, in, inLength);
+    }
+
+    bool readRegisters(uint8_t address, const uint8_t* commands, uint8_t count, uint8_t* data, uint8_t length, bool* ok) {
+        bool complete = true;
+        for (uint8_t i = 0; i < count; i++, data += length) {
+            ok[i] = writeRead(address, &commands[i], 1, data, length);
+            if (!ok[i]) {
+                memset(data, 0, length);
+                complete = false;
+            }
+        }
+        return complete;
+    }
+
+    uint32_t micros() const {
+        return _sim->micros();
+    }
+
+    void delayMicros(uint32_t micros) {
+        _sim->advance(micros);
+    }
+
+    RACM600Simulator& simulator() { return *_sim; }
+
+private:
+    RACM600Simulator* _sim;
+};
+
+#ifndef RACM600_SIM_WIRE_BUFFER
+#define RACM600_SIM_WIRE_BUFFER 32  // Bytes per transfer, as the AVR Wire library
+#endif
+
+/*
+ * The Arduino Wire (TwoWire) interface over a RACM600Simulator, for code written against
+ * Wire rather than the bus concept. endTransmission() returns 0 on success and 2 when the
+ * transfer was NAKed; requestFrom() returns the bytes received, 0 on a NAK.
+ */
+class RACM600SimWire {
+public:
+    RACM600SimWire(RACM600Simulator& sim) : _sim(&sim), _address(0), _txLength(0), _rxLength(0), _rxIndex(0) {}
+
+    void begin() {}
+    void setClock(uint32_t hz) { _sim->setClock(hz); }
+
+    void beginTransmission(uint8_t address) {
+        _address = address;
+        _txLength = 0;
+    }
+
+    size_t write(uint8_t value) {
+        if (_txLength == RACM600_SIM_WIRE_BUFFER) return 0;
+        _tx[_txLength++] = value;
+        return 1;
+    }
+
+    size_t write(const uint8_t* data, size_t length) {
+        size_t written = 0;
+        while (written < length && write(data[written])) {
+            written++;
+        }
+        return written;
+    }
+
+    uint8_t endTransmission(bool stop = true) {
+        return _sim->write(_address, _tx, _txLength, stop) ? 0 : 2;
+    }
+
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t stop = 1) {
+        (void)stop;     // A read always ends its transaction here
+        if (quantity > RACM600_SIM_WIRE_BUFFER) quantity = RACM600_SIM_WIRE_BUFFER;
+        _rxLength = _sim->read(address, _rx, quantity) ? quantity : 0;
+        _rxIndex = 0;
+        return _rxLength;
+    }
+
+    int available() { return _rxLength - _rxIndex; }
+    int read() { return _rxIndex < _rxLength ? _rx[_rxIndex++] : -1; }
+
+    RACM600Simulator& simulator() { return *_sim; }
+
+private:
+    RACM600Simulator* _sim;
+    uint8_t _address;
+    uint8_t _tx[RACM600_SIM_WIRE_BUFFER];
+    uint8_t _txLength;
+    uint8_t _rx[RACM600_SIM_WIRE_BUFFER];
+    uint8_t _rxLength;
+    uint8_t _rxIndex;
+};
+
+#endif
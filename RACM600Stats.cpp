@@ -0,0 +1,158 @@
+/**
+ *   @file RACM600Stats.cpp
+ *
+ *  Optional per-command bus instrumentation for the RACM600 library.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this
+ *  code to support the exploration and documentation of deep-water
+ *  ecosystems, contributing to their conservation and management. To
+ *  sustain our mission and initiatives, please consider donating at
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+#include <string.h>
+
+#include "RACM600Stats.h"
+
+#ifdef RACM600_STATS
+
+RACM600CommandStats RACM600Stats::_slots[RACM600_STATS_SLOTS];
+uint8_t RACM600Stats::_used = 0;
+uint32_t RACM600Stats::_overflow = 0;
+
+// Counts one transaction of cmd that took micros and put bytes on the wire
+void RACM600Stats::record(uint8_t cmd, uint32_t micros, uint8_t bytes, bool ok) {
+    RACM600CommandStats* stats = lookup(cmd);
+    if (stats == NULL) {
+        if (_used == RACM600_STATS_SLOTS) {
+            if (_overflow != 0xFFFFFFFF) _overflow++;
+            return;
+        }
+        stats = &_slots[_used++];
+        stats->cmd = cmd;
+    }
+
+    if (stats->transactions != 0xFFFFFFFF) stats->transactions++;
+    if (!ok && stats->errors != 0xFFFF) stats->errors++;
+    stats->bytes = stats->bytes > 0xFFFFFFFF - bytes ? 0xFFFFFFFF : stats->bytes + bytes;
+    uint16_t& count = stats->latency[bucket(micros)];
+    if (count != 0xFFFF) count++;
+}
+
+// Clears every counter and frees every slot
+void RACM600Stats::reset() {
+    memset(_slots, 0, sizeof(_slots));
+    _used = 0;
+    _overflow = 0;
+}
+
+// Command codes seen so far
+uint8_t RACM600Stats::size() {
+    return _used;
+}
+
+// Counters of cmd, or NULL if it has not crossed the bus
+const RACM600CommandStats* RACM600Stats::find(uint8_t cmd) {
+    return lookup(cmd);
+}
+
+RACM600CommandStats* RACM600Stats::lookup(uint8_t cmd) {
+    for (uint8_t i = 0; i < _used; i++) {
+        if (_slots[i].cmd == cmd) {
+            return &_slots[i];
+        }
+    }
+    return NULL;
+}
+
+// Counters in slot index, 0 to size() - 1
+const RACM600CommandStats& RACM600Stats::slot(uint8_t index) {
+    return _slots[index];
+}
+
+// Transactions not recorded because every slot was taken
+uint32_t RACM600Stats::overflow() {
+    return _overflow;
+}
+
+// Histogram bucket of a latency: 0 below 64 us, one bucket per doubling after that
+uint8_t RACM600Stats::bucket(uint32_t micros) {
+    uint8_t index = 0;
+    for (micros >>= 6; micros != 0 && index < RACM600_STATS_BUCKETS - 1; micros >>= 1) {
+        index++;
+    }
+    return index;
+}
+
+static uint8_t* putLittleEndian(uint8_t* out, uint32_t value, uint8_t width) {
+    for (uint8_t i = 0; i < width; i++, value >>= 8) {
+        *out++ = value & 0xFF;
+    }
+    return out;
+}
+
+size_t RACM600Stats::serialize(uint8_t* buffer, size_t size) {
+    uint8_t* out = buffer;
+    for (uint8_t i = 0; i < _used && size >= RACM600_STATS_RECORD_SIZE; i++, size -= RACM600_STATS_RECORD_SIZE) {
+        const RACM600CommandStats& stats = _slots[i];
+        *out++ = stats.cmd;
+        out = putLittleEndian(out, stats.transactions, 4);
+        out = putLittleEndian(out, stats.errors, 2);
+        out = putLittleEndian(out, stats.bytes, 4);
+        for (uint8_t b = 0; b < RACM600_STATS_BUCKETS; b++) {
+            out = putLittleEndian(out, stats.latency[b], 2);
+        }
+    }
+    return out - buffer;
+}
+
+#ifdef ARDUINO
+// One line per command: code, transactions, errors, bytes, then the latency buckets
+void RACM600Stats::print(Print& out) {
+    out.println(F("cmd  count  errors  bytes  <64us <128 <256 <512 <1ms <2ms <4ms >=4ms"));
+    for (uint8_t i = 0; i < _used; i++) {
+        const RACM600CommandStats& stats = _slots[i];
+        out.print(F("0x"));
+        if (stats.cmd < 0x10) out.print('0');
+        out.print(stats.cmd, HEX);
+        out.print(' ');
+        out.print(stats.transactions);
+        out.print(' ');
+        out.print(stats.errors);
+        out.print(' ');
+        out.print(stats.bytes);
+        for (uint8_t b = 0; b < RACM600_STATS_BUCKETS; b++) {
+            out.print(' ');
+            out.print(stats.latency[b]);
+        }
+        out.println();
+    }
+    if (_overflow) {
+        out.print(F("untracked "));
+        out.println(_overflow);
+    }
+}
+#else
+void RACM600Stats::print(FILE* out) {
+    fprintf(out, "cmd  count  errors  bytes  <64us <128 <256 <512 <1ms <2ms <4ms >=4ms\n");
+    for (uint8_t i = 0; i < _used; i++) {
+        const RACM600CommandStats& stats = _slots[i];
+        fprintf(out, "0x%02X %lu %u %lu", stats.cmd, (unsigned long)stats.transactions,
+                (unsigned)stats.errors, (unsigned long)stats.bytes);
+        for (uint8_t b = 0; b < RACM600_STATS_BUCKETS; b++) {
+            fprintf(out, " %u", (unsigned)stats.latency[b]);
+        }
+        fprintf(out, "\n");
+    }
+    if (_overflow) {
+        fprintf(out, "untracked %lu\n", (unsigned long)_overflow);
+    }
+}
+#endif
+
+#endif
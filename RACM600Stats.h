@@ -0,0 +1,87 @@
+/**
+ *   @file RACM600Stats.h
+ *
+ *  Optional per-command bus instrumentation for the RACM600 library. Define
+ *  RACM600_STATS for the whole build (library sources included) to record,
+ *  for every PMBus command code, how often it crossed the bus, how often it
+ *  failed, the bytes it put on the wire and a latency histogram. Without the
+ *  define nothing is stored and every hook compiles away.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this
+ *  code to support the exploration and documentation of deep-water
+ *  ecosystems, contributing to their conservation and management. To
+ *  sustain our mission and initiatives, please consider donating at
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+
+#ifndef RACM600_STATS_H
+#define RACM600_STATS_H
+
+#include "RACM600Platform.h"
+
+#ifdef RACM600_STATS
+
+#ifndef ARDUINO
+#include <stdio.h>
+#endif
+
+#ifndef RACM600_STATS_SLOTS
+#define RACM600_STATS_SLOTS 16      // Distinct command codes tracked, 27 bytes of RAM each
+#endif
+
+#define RACM600_STATS_BUCKETS 8     // Latency buckets: <64 us, then doubling, last is >= 4096 us
+#define RACM600_STATS_RECORD_SIZE 27 // Bytes per command in serialize() output
+
+// Counters for one command code. Counts saturate instead of wrapping.
+struct RACM600CommandStats {
+    uint8_t cmd;
+    uint32_t transactions;
+    uint16_t errors;                // NAKs, short reads and PEC mismatches
+    uint32_t bytes;                 // Bytes on the wire, including address bytes
+    uint16_t latency[RACM600_STATS_BUCKETS];
+};
+
+/*
+ * Global table of RACM600CommandStats, shared by every RACM600Device in the build. Slots are
+ * handed out to command codes in the order they are first seen; once all are taken, further
+ * codes are only counted by overflow().
+ */
+class RACM600Stats {
+public:
+    static void record(uint8_t cmd, uint32_t micros, uint8_t bytes, bool ok);
+    static void reset();
+
+    static uint8_t size();
+    static const RACM600CommandStats* find(uint8_t cmd);
+    static const RACM600CommandStats& slot(uint8_t index);
+    static uint32_t overflow();
+
+    static uint8_t bucket(uint32_t micros);
+
+    // Little endian records of RACM600_STATS_RECORD_SIZE bytes, in the field order of
+    // RACM600CommandStats. Returns the bytes written, only whole records are written.
+    static size_t serialize(uint8_t* buffer, size_t size);
+
+#ifdef ARDUINO
+    static void print(Print& out = Serial);
+#else
+    static void print(FILE* out = stdout);
+#endif
+
+private:
+    static RACM600CommandStats* lookup(uint8_t cmd);
+
+    static RACM600CommandStats _slots[RACM600_STATS_SLOTS];
+    static uint8_t _used;
+    static uint32_t _overflow;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ *   @file RACM600WireBus.h
+ *
+ *  Arduino Wire transport for the RACM600 library, the default bus behind
+ *  the RACM600 class.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this 
+ *  code to support the exploration and documentation of deep-water 
+ *  ecosystems, contributing to their conservation and management. To 
+ *  sustain our mission and initiatives, please consider donating at 
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+
+#ifndef RACM600_WIRE_BUS_H
+#define RACM600_WIRE_BUS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+/*
+ * Bus concept used by RACM600Device. A bus is a small copyable handle providing:
+ *
+ *   void begin();
+ *   bool write(uint8_t address, const uint8_t* data, uint8_t length, bool stop = true);
+ *   bool read(uint8_t address, uint8_t* data, uint8_t length);
+ *   bool writeRead(uint8_t address, const uint8_t* out, uint8_t outLength, uint8_t* in, uint8_t inLength);
+ *   bool readRegisters(uint8_t address, const uint8_t* commands, uint8_t count, uint8_t* data, uint8_t length, bool* ok);
+ *   uint32_t micros() const;
+ *   void delayMicros(uint32_t micros);
+ *
+ * write() with stop = false holds the bus so the next transfer starts with a repeated
+ * start. read() and writeRead() return true only when every requested byte arrived.
+ * readRegisters() performs count command/read pairs of length bytes each, stored back
+ * to back in data, letting transports that can batch transfers do so. ok[i] reports
+ * whether register i arrived, a failed register is zero filled, and the call returns
+ * true only when every register arrived. delayMicros()
+ * waits between retries and may yield to other work.
+ * Every call resolves at compile time, there are no virtual functions.
+ */
+class RACM600WireBus {
+public:
+    RACM600WireBus(TwoWire& wire = Wire) : _wire(&wire) {}
+
+    void begin() {
+        _wire->begin();
+    }
+
+    bool write(uint8_t address, const uint8_t* data, uint8_t length, bool stop = true) {
+        _wire->beginTransmission(address);
+        _wire->write(data, length);
+        return _wire->endTransmission(stop) == 0;
+    }
+
+    bool read(uint8_t address, uint8_t* data, uint8_t length) {
+        _wire->requestFrom(address, length);
+        if (_wire->available() < length) {
+            return false;
+        }
+        for (uint8_t i = 0; i < length; i++) {
+            data[i] = _wire->read();
+        }
+        return true;
+    }
+
+    // Write, repeated start, read
+    bool writeRead(uint8_t address, const uint8_t* out, uint8_t outLength, uint8_t* in, uint8_t inLength) {
+        return write(address, out, outLength, false) && read(address, in, inLength);
+    }
+
+    // One write/read pair per register, failed registers are zero filled
+    bool readRegisters(uint8_t address, const uint8_t* commands, uint8_t count, uint8_t* data, uint8_t length, bool* ok) {
+        bool complete = true;
+        for (uint8_t i = 0; i < count; i++, data += length) {
+            ok[i] = writeRead(address, &commands[i], 1, data, length);
+            if (!ok[i]) {
+                memset(data, 0, length);
+                complete = false;
+            }
+        }
+        return complete;
+    }
+
+    uint32_t micros() const {
+        return ::micros();
+    }
+
+    // delayMicroseconds() is only accurate up to 16383, whole milliseconds go to delay()
+    void delayMicros(uint32_t micros) {
+        delay(micros / 1000);
+        delayMicroseconds(micros % 1000);
+    }
+
+private:
+    TwoWire* _wire;
+};
+
+#endif
@@ -0,0 +1,154 @@
+/**
+ *   @file bench_adaptive.cpp
+ *
+ *  Bus utilization and detection latency of RACM600AdaptivePoller against fixed
+ *  rate polling of the same five channels, over a simulated load profile at
+ *  100 kHz: an idle half hour, a temperature ramp to OT_WARN, current steps past
+ *  IOUT_OC_WARN at several phases of the schedule and a slow current ramp.
+ *  Fixed rate polling is the same poller with equal minimum and maximum periods.
+ */
+
+#include <stdio.h>
+#include "RACM600Sim.h"
+#include "RACM600Adaptive.h"
+
+typedef RACM600Device<RACM600SimBus> Device;
+typedef RACM600AdaptivePoller<RACM600SimBus> Poller;
+
+static const uint32_t NOT_DETECTED = 0xFFFFFFFFUL;
+static const uint8_t STEPS = 8;
+
+enum Quantity { CURRENT, TEMPERATURE };
+
+struct Rig {
+    RACM600Simulator sim;
+    RACM600SimDevice supply;
+    Device psu;
+    Poller poller;
+    uint32_t rampBusMicros;     // Bus and wall time spent inside ramp()
+    uint32_t rampMicros;
+
+    Rig(uint32_t minPeriod, uint32_t maxPeriod)
+        : sim(100000), supply(0x27), psu(0x27, RACM600SimBus(sim)), poller(psu), rampBusMicros(0), rampMicros(0) {
+        sim.attach(supply);
+        psu.begin();
+        poller.setPeriods(minPeriod, maxPeriod);
+        poller.begin();
+        supply.setCurrent(20.0f);
+    }
+
+    void set(Quantity quantity, float value) {
+        if (quantity == CURRENT) supply.setCurrent(value);
+        else supply.setTemperature(1, value);
+    }
+
+    // Value the supply reports right now, in the poller's units
+    int32_t reading(Quantity quantity) const {
+        return quantity == CURRENT
+            ? RACM600Linear::decodeLinear11Scaled(supply.reg(RACM600_READ_IOUT), 1000)
+            : RACM600Linear::decodeLinear11Scaled(supply.reg(RACM600_READ_TEMPERATURE_1), 100);
+    }
+
+    // Runs the poller on a 1 ms loop
+    void run(uint32_t millis) {
+        for (uint32_t ms = 0; ms < millis; ms++) {
+            poller.tick();
+            sim.advance(1000);
+        }
+    }
+
+    // Moves quantity from its current value to target at perSecond, updated every 10 ms.
+    // Returns the microseconds from the reading reaching the limit to the poller seeing it.
+    uint32_t ramp(uint8_t channel, Quantity quantity, float from, float target, float perSecond) {
+        uint32_t start = sim.micros();
+        uint32_t busStart = poller.busMicros();
+        uint32_t latency = watch(channel, quantity, from, target, perSecond);
+        rampMicros += sim.micros() - start;
+        rampBusMicros += poller.busMicros() - busStart;
+        return latency;
+    }
+
+    uint32_t watch(uint8_t channel, Quantity quantity, float from, float target, float perSecond) {
+        float value = from;
+        uint32_t crossed = 0;
+        bool reached = false;
+        for (uint32_t ms = 0; ms < 600000; ms++) {
+            if (ms % 10 == 0 && value < target) {
+                value += perSecond / 100;
+                if (value > target) value = target;
+                set(quantity, value);
+                if (!reached && reading(quantity) >= poller.limit(channel)) {
+                    crossed = sim.micros();
+                    reached = true;
+                }
+            }
+            poller.tick();
+            if (reached && poller.exceeded(channel)) {
+                return sim.micros() - crossed;
+            }
+            sim.advance(1000);
+        }
+        return NOT_DETECTED;
+    }
+
+    // Back to 20 A and 30 C, faults cleared, and a minute for the periods to relax
+    void recover() {
+        supply.setCurrent(20.0f);
+        supply.setTemperature(1, 30.0f);
+        psu.clearFaults();
+        run(60000);
+    }
+};
+
+static void printLatency(uint32_t micros) {
+    if (micros == NOT_DETECTED) printf("  %9s", "missed");
+    else printf("  %9.1f", micros / 1000.0);
+}
+
+static void profile(const char* name, uint32_t minPeriod, uint32_t maxPeriod) {
+    Rig rig(minPeriod, maxPeriod);
+    rig.run(1000);
+    rig.poller.resetStatistics();
+
+    rig.run(1800000UL);        // Half an hour, micros() wraps after 71 minutes
+    uint16_t idle = rig.poller.busUtilization();
+
+    uint32_t temperature = rig.ramp(RACM600_ADAPT_TEMPERATURE_1, TEMPERATURE, 30.0f, 105.0f, 0.5f);
+    rig.recover();
+
+    uint32_t step = 0;
+    for (uint8_t i = 0; i < STEPS; i++) {
+        rig.run(1 + i * 263);       // Step at a different phase of the schedule each time
+        uint32_t latency = rig.ramp(RACM600_ADAPT_IOUT, CURRENT, 20.0f, 53.0f, 1e9f);
+        if (latency > step) step = latency;
+        rig.recover();
+    }
+
+    uint32_t current = rig.ramp(RACM600_ADAPT_IOUT, CURRENT, 20.0f, 53.0f, 33.0f / 60);
+    rig.recover();
+    uint16_t active = (uint16_t)((uint64_t)rig.rampBusMicros * 1000 / rig.rampMicros);
+
+    uint32_t worst = temperature;
+    if (step > worst) worst = step;
+    if (current > worst) worst = current;
+
+    printf("%-14s %5u.%u%%  %5u.%u%%", name, idle / 10, idle % 10, active / 10, active % 10);
+    printLatency(temperature);
+    printLatency(step);
+    printLatency(current);
+    printLatency(worst);
+    printf("\n");
+}
+
+int main() {
+    printf("5 channels at 100 kHz. Bus utilization while idle and during the ramps and steps,\n");
+    printf("then latencies in ms from the reading reaching its limit to the poller seeing it.\n");
+    printf("%-14s %7s  %7s  %9s  %9s  %9s  %9s\n",
+           "policy", "idle", "ramps", "OT ramp", "OC step", "OC ramp", "worst");
+    profile("adaptive", RACM600_ADAPTIVE_MIN_PERIOD, RACM600_ADAPTIVE_MAX_PERIOD);
+    profile("fixed 10 ms", 10000, 10000);
+    profile("fixed 100 ms", 100000, 100000);
+    profile("fixed 1 s", 1000000, 1000000);
+    profile("fixed 2 s", 2000000, 2000000);
+    return 0;
+}
@@ -0,0 +1,74 @@
+/**
+ *   @file bench_alert.cpp
+ *
+ *  Cost of finding the one supply behind SMBALERT# at 100 kHz: a single Alert
+ *  Response Address read and the faults of the supply that answers, as
+ *  serviceAlert(devices, count, report) does, against a naive readFaults()
+ *  scan of every supply. Each row averages an alert from every position.
+ */
+
+#include <stdio.h>
+#include "RACM600Sim.h"
+
+typedef RACM600Device<RACM600SimBus> Device;
+
+enum Method { ARA, SCAN };
+
+static void run(uint8_t supplies, Method method) {
+    RACM600Simulator sim(100000);
+    RACM600SimDevice devices[RACM600_SIM_MAX_DEVICES];
+    Device psus[RACM600_SIM_MAX_DEVICES];
+    for (uint8_t i = 0; i < supplies; i++) {
+        devices[i] = RACM600SimDevice(0x20 + i);
+        sim.attach(devices[i]);
+        psus[i] = Device(0x20 + i, RACM600SimBus(sim));
+        psus[i].begin();
+    }
+
+    uint32_t transactions = 0;
+    uint32_t micros = 0;
+    uint32_t missed = 0;
+    for (uint8_t alerting = 0; alerting < supplies; alerting++) {
+        devices[alerting].raiseFault(RACM600_STATUS_CML, 0x80);
+        uint32_t startTransactions = sim.transactions();
+        uint32_t start = sim.micros();
+
+        RACM600FaultReport report;
+        int found = -1;
+        if (method == ARA) {
+            uint8_t address = psus[0].readAlertResponse();
+            for (uint8_t i = 0; i < supplies; i++) {
+                if (psus[i].address() == address) {
+                    psus[i].readFaults(report);
+                    found = i;
+                    break;
+                }
+            }
+        } else {
+            // Without the ARA nothing says how many supplies alert, so every one is read
+            for (uint8_t i = 0; i < supplies; i++) {
+                if (psus[i].readFaults(report) != 0) found = i;
+            }
+        }
+
+        micros += sim.micros() - start;
+        transactions += sim.transactions() - startTransactions;
+        if (found != alerting) missed++;
+        psus[alerting].clearFaults();
+        devices[alerting].acknowledgeAlert();   // The scan leaves SMBALERT# low, release it
+    }
+
+    printf("%8u  %-10s %8.1f  %8.1f  %lu\n", supplies, method == ARA ? "ARA" : "scan",
+           transactions / (double)supplies, micros / (double)supplies, (unsigned long)missed);
+}
+
+int main() {
+    printf("One alerting supply at 100 kHz, averaged over its position\n");
+    printf("%8s  %-10s %8s  %8s  %s\n", "supplies", "method", "trans", "us", "missed");
+    const uint8_t counts[] = { 1, 2, 4, 8, 16 };
+    for (uint8_t c = 0; c < sizeof(counts); c++) {
+        run(counts[c], ARA);
+        run(counts[c], SCAN);
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+/**
+ *   @file bench_bank.cpp
+ *
+ *  RACM600Bank sample rates for 1, 4, 8 and 16 supplies at 100 kHz and 400 kHz.
+ *  The sketch calls tick() with a 1 ms budget every 2 ms for one simulated
+ *  second; each row gives the snapshots per second of the bank and of each
+ *  supply, and the oldest data the sketch held.
+ */
+
+#include <stdio.h>
+#include "RACM600Sim.h"
+#include "RACM600Bank.h"
+
+#define MAX_SUPPLIES 16
+
+typedef RACM600Bank<MAX_SUPPLIES, RACM600SimBus> Bank;
+
+static const uint32_t DURATION = 1000000;
+static const uint32_t PERIOD = 2000;
+static const uint32_t BUDGET = 1000;
+
+static void run(uint32_t clockHz, uint8_t supplies) {
+    RACM600Simulator sim(clockHz);
+    RACM600SimDevice devices[MAX_SUPPLIES];
+    uint8_t addresses[MAX_SUPPLIES];
+    for (uint8_t i = 0; i < supplies; i++) {
+        addresses[i] = 0x20 + i;
+        devices[i] = RACM600SimDevice(addresses[i]);
+        sim.attach(devices[i]);
+    }
+    Bank bank(addresses, supplies, BUDGET, RACM600SimBus(sim));
+    bank.begin();
+
+    uint32_t worst = 0;
+    uint32_t start = sim.micros();
+    uint32_t next = start;
+    while (sim.micros() - start < DURATION) {
+        uint32_t stale = bank.maxStaleness();
+        if (stale != 0xFFFFFFFFUL && stale > worst) {
+            worst = stale;                  // Oldest data just before a tick refreshes it
+        }
+        bank.tick();
+        next += PERIOD;
+        if ((int32_t)(next - sim.micros()) > 0) sim.advance(next - sim.micros());
+    }
+    uint32_t elapsed = sim.micros() - start;
+
+    uint32_t samples = 0;
+    uint32_t failures = 0;
+    for (uint8_t i = 0; i < supplies; i++) {
+        samples += bank.samples(i);
+        failures += bank.failures(i);
+    }
+    double perSecond = samples * 1e6 / elapsed;
+    printf("%4lu kHz  %8u  %10.1f  %10.1f  %8.1f  %lu\n", (unsigned long)(clockHz / 1000), supplies,
+           perSecond, perSecond / supplies, worst / 1000.0, (unsigned long)failures);
+}
+
+int main() {
+    printf("tick() every %lu us with a %lu us budget, for %lu s\n", (unsigned long)PERIOD,
+           (unsigned long)BUDGET, (unsigned long)(DURATION / 1000000));
+    printf("%8s  %8s  %10s  %10s  %8s  %s\n", "clock", "supplies", "bank/s", "supply/s", "stale ms", "failed");
+    const uint32_t clocks[] = { 100000, 400000 };
+    const uint8_t counts[] = { 1, 4, 8, 16 };
+    for (uint8_t c = 0; c < 2; c++) {
+        for (uint8_t n = 0; n < sizeof(counts); n++) run(clocks[c], counts[n]);
+    }
+    return 0;
+}
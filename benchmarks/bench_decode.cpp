@@ -0,0 +1,87 @@
+/**
+ *   @file bench_decode.cpp
+ *
+ *  Host cost of the LINEAR decoders: the float path against the integer
+ *  decode*Scaled() path, in nanoseconds per word over every raw word and in
+ *  code bytes of each out of line copy, read from the symbol table with nm.
+ *  Host numbers rank the two paths; AVR has no FPU, so its float path costs
+ *  more again.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "RACM600Sim.h"
+
+#ifndef RACM600_NM
+#define RACM600_NM "nm"
+#endif
+
+static const uint32_t PASSES = 200;
+
+// VOUT_MODE is read at run time in the driver, keep the compiler from folding it in
+static volatile uint8_t voutMode = 0x17;
+
+// Out of line copies, so each path is timed and sized on its own
+extern "C" {
+__attribute__((noinline)) float benchFloat11(uint16_t raw) {
+    return RACM600Linear::decodeLinear11(raw);
+}
+__attribute__((noinline)) int32_t benchScaled11(uint16_t raw) {
+    return RACM600Linear::decodeLinear11Scaled(raw, 1000);
+}
+__attribute__((noinline)) float benchFloat16(uint16_t raw) {
+    return RACM600Linear::decodeLinear16(raw, voutMode);
+}
+__attribute__((noinline)) int32_t benchScaled16(uint16_t raw) {
+    return RACM600Linear::decodeLinear16Scaled(raw, voutMode, 1000);
+}
+}
+
+static volatile float floatSink;
+static volatile int32_t integerSink;
+
+template <class Decode, class Sink>
+static double time(Decode decode, volatile Sink& sink) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t pass = 0; pass < PASSES; pass++) {
+        for (uint32_t raw = 0; raw <= 0xFFFF; raw++) sink = decode((uint16_t)raw);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (PASSES * 65536.0);
+}
+
+// Size of a symbol from nm -S, 0 when nm is not available
+static unsigned long symbolSize(const char* program, const char* symbol) {
+    char command[512];
+    snprintf(command, sizeof(command), "%s -S \"%s\" 2>/dev/null", RACM600_NM, program);
+    FILE* nm = popen(command, "r");
+    if (!nm) return 0;
+    char line[512];
+    unsigned long size = 0;
+    while (fgets(line, sizeof(line), nm)) {
+        char address[64], sizeField[64], type[8], name[256];
+        if (sscanf(line, "%63s %63s %7s %255s", address, sizeField, type, name) == 4 &&
+            strcmp(name, symbol) == 0) {
+            size = strtoul(sizeField, 0, 16);
+        }
+    }
+    pclose(nm);
+    return size;
+}
+
+static void report(const char* program, const char* name, const char* symbol, double nanos) {
+    printf("%-38s %8.2f  %6lu\n", name, nanos, symbolSize(program, symbol));
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    printf("%lu passes over all 65536 words\n", (unsigned long)PASSES);
+    printf("%-38s %8s  %6s\n", "decoder", "ns/word", "bytes");
+    report(argv[0], "decodeLinear11()", "benchFloat11", time(benchFloat11, floatSink));
+    report(argv[0], "decodeLinear11Scaled(raw, 1000)", "benchScaled11", time(benchScaled11, integerSink));
+    report(argv[0], "decodeLinear16(raw, mode)", "benchFloat16", time(benchFloat16, floatSink));
+    report(argv[0], "decodeLinear16Scaled(raw, mode, 1000)", "benchScaled16", time(benchScaled16, integerSink));
+    return 0;
+}
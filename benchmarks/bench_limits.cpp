@@ -0,0 +1,77 @@
+/**
+ *   @file bench_limits.cpp
+ *
+ *  Bus cost of applying one set of limits to 16 supplies at 400 kHz, one
+ *  supply at a time with setLimits() against RACM600Bank::setLimits(), which
+ *  sends each changed limit to every supply in one Group Command.
+ */
+
+#include <stdio.h>
+#include "RACM600Sim.h"
+#include "RACM600Bank.h"
+
+#define SUPPLIES 16
+
+typedef RACM600Bank<SUPPLIES, RACM600SimBus> Bank;
+
+struct Rig {
+    RACM600Simulator sim;
+    RACM600SimDevice supplies[SUPPLIES];
+    uint8_t addresses[SUPPLIES];
+    Bank bank;
+
+    Rig() : sim(400000), bank(addressList(), SUPPLIES, 1000, RACM600SimBus(sim)) {
+        for (uint8_t i = 0; i < SUPPLIES; i++) {
+            supplies[i] = RACM600SimDevice(addresses[i]);
+            sim.attach(supplies[i]);
+        }
+        bank.begin();
+    }
+
+    const uint8_t* addressList() {
+        for (uint8_t i = 0; i < SUPPLIES; i++) addresses[i] = 0x20 + i;
+        return addresses;
+    }
+
+    // Sets limits on every supply, through the bank or one supply at a time
+    uint8_t apply(bool group, const RACM600Limits& limits, uint8_t page) {
+        if (group) {
+            return bank.setLimits(limits, page);
+        }
+        uint8_t verified = 0;
+        for (uint8_t i = 0; i < SUPPLIES; i++) {
+            if (bank.device(i).setLimits(limits, page) == RACM600_OK) verified++;
+        }
+        return verified;
+    }
+};
+
+static void step(Rig& rig, bool group, const char* name, const RACM600Limits& limits, uint8_t page) {
+    uint32_t transactions = rig.sim.transactions();
+    uint32_t start = rig.sim.micros();
+    uint8_t verified = rig.apply(group, limits, page);
+    printf("  %-24s %8lu  %8lu  %8u\n", name, (unsigned long)(rig.sim.transactions() - transactions),
+           (unsigned long)(rig.sim.micros() - start), verified);
+}
+
+static void run(bool group) {
+    Rig rig;
+    RACM600Limits limits = { 14000, 54000, 50000 };
+    RACM600Limits aux = { 6000, 3250, 2750 };
+
+    printf("%s\n", group ? "RACM600Bank::setLimits(), Group Commands" : "setLimits() per supply");
+    printf("  %-24s %8s  %8s  %8s\n", "", "transact", "bus us", "verified");
+    step(rig, group, "first time", limits, RACM600_PAGE_MAIN);
+    limits.ioutOcWarn_mA = 48000;
+    step(rig, group, "one limit changed", limits, RACM600_PAGE_MAIN);
+    step(rig, group, "unchanged", limits, RACM600_PAGE_MAIN);
+    step(rig, group, "AUX first time", aux, RACM600_PAGE_AUX);
+    step(rig, group, "Main unchanged after AUX", limits, RACM600_PAGE_MAIN);
+}
+
+int main() {
+    printf("%u supplies at 400 kHz\n", SUPPLIES);
+    run(false);
+    run(true);
+    return 0;
+}
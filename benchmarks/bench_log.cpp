@@ -0,0 +1,103 @@
+/**
+ *   @file bench_log.cpp
+ *
+ *  Size and encode time of the binary telemetry log on a week of one-minute
+ *  snapshots from a simulated supply, with a daily load cycle, output ripple,
+ *  ambient temperature drift and line variation. The trace is seeded, so the
+ *  byte counts are the same on every host.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "RACM600Sim.h"
+#include "RACM600Log.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_CYCLES() __rdtsc()
+#endif
+
+static const uint32_t SNAPSHOTS = 7UL * 24 * 60;
+static const uint8_t PASSES = 20;
+
+static RACM600Snapshot trace[SNAPSHOTS];
+static uint8_t stream[SNAPSHOTS * RACM600_LOG_MAX_RECORD];
+
+// Deterministic 0 .. range-1, independent of the C library's rand()
+static uint32_t randomBelow(uint32_t range) {
+    static uint32_t state = 0x2545F491UL;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state % range;
+}
+
+static void record() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    RACM600Device<RACM600SimBus> psu(0x27, RACM600SimBus(sim));
+    psu.begin();
+
+    for (uint32_t i = 0; i < SNAPSHOTS; i++) {
+        uint32_t hour = (i / 60) % 24;
+        float load = 20.0f + (hour > 8 && hour < 18 ? 10.0f : 0.0f) + randomBelow(100) / 100.0f;
+        supply.setCurrent(load);
+        supply.setVoltage(12.0f + ((int)randomBelow(5) - 2) * 0.002f);
+        supply.setTemperature(1, 20.0f + hour * 0.3f + randomBelow(10) / 20.0f);
+        supply.setInputVoltage(230.0f + ((int)randomBelow(7) - 3));
+        sim.advance(60000000UL);
+        psu.readSnapshot(trace[i]);
+    }
+}
+
+int main() {
+    record();
+
+    RACM600LogEncoder encoder;
+    size_t length = 0;
+    for (uint32_t i = 0; i < SNAPSHOTS; i++) {
+        length += encoder.encode(trace[i], stream + length);
+    }
+
+    // Every record must decode back to its snapshot
+    RACM600LogDecoder decoder;
+    size_t position = 0;
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < SNAPSHOTS; i++) {
+        RACM600Snapshot snapshot;
+        size_t used = decoder.decode(stream + position, length - position, snapshot);
+        position += used;
+        if (used == 0 || memcmp(&snapshot, &trace[i], sizeof(snapshot)) != 0) mismatches++;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#ifdef BENCH_CYCLES
+    uint64_t cycles = BENCH_CYCLES();
+#endif
+    size_t check = 0;
+    for (uint8_t pass = 0; pass < PASSES; pass++) {
+        encoder.reset();
+        size_t offset = 0;
+        for (uint32_t i = 0; i < SNAPSHOTS; i++) {
+            offset += encoder.encode(trace[i], stream + offset);
+        }
+        check += offset;
+    }
+#ifdef BENCH_CYCLES
+    cycles = BENCH_CYCLES() - cycles;
+#endif
+    double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    uint32_t encodes = (uint32_t)PASSES * SNAPSHOTS;
+
+    printf("%lu one-minute snapshots (one week), keyframe every %u records\n",
+           (unsigned long)SNAPSHOTS, encoder.keyframeInterval());
+    printf("log bytes        %lu\n", (unsigned long)length);
+    printf("bytes / snapshot %.2f (raw snapshot %u)\n", (double)length / SNAPSHOTS, (unsigned)sizeof(RACM600Snapshot));
+    printf("ns / encode      %.1f\n", nanos / encodes);
+#ifdef BENCH_CYCLES
+    printf("TSC / encode     %.1f\n", (double)cycles / encodes);
+#endif
+    printf("decode mismatches %lu\n", (unsigned long)mismatches);
+    return mismatches == 0 && check == (size_t)PASSES * length ? 0 : 1;
+}
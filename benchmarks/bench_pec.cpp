@@ -0,0 +1,58 @@
+/**
+ *   @file bench_pec.cpp
+ *
+ *  Cost of Packet Error Checking on the simulated bus at 100 kHz and 400 kHz:
+ *  word reads and snapshots with PEC off and on, in transactions per second of
+ *  bus time and bytes per transaction.
+ */
+
+#include <stdio.h>
+#include "RACM600Sim.h"
+
+typedef RACM600Device<RACM600SimBus> Device;
+
+static const uint32_t ROUNDS = 1000;
+
+static void run(uint32_t clockHz, bool snapshots, bool pec) {
+    RACM600Simulator sim(clockHz);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    Device psu(0x27, RACM600SimBus(sim));
+    psu.begin();
+    psu.setPec(pec);
+
+    uint32_t failures = 0;
+    uint32_t transactions = sim.transactions();
+    uint32_t bytes = sim.bytes();
+    uint32_t start = sim.micros();
+    for (uint32_t i = 0; i < ROUNDS; i++) {
+        if (snapshots) {
+            RACM600Snapshot snapshot;
+            if (!psu.readSnapshot(snapshot)) failures++;
+        } else {
+            uint16_t raw;
+            if (psu.tryReadWord(RACM600_READ_IOUT, raw) != RACM600_OK) failures++;
+        }
+    }
+    uint32_t elapsed = sim.micros() - start;
+    transactions = sim.transactions() - transactions;
+    bytes = sim.bytes() - bytes;
+
+    printf("%4lu kHz  %-14s %-4s %10.1f  %6.2f  %lu\n", (unsigned long)(clockHz / 1000),
+           snapshots ? "readSnapshot()" : "tryReadWord()", pec ? "on" : "off",
+           transactions * 1e6 / elapsed, bytes / (double)transactions,
+           (unsigned long)(failures + psu.pecErrors()));
+}
+
+int main() {
+    printf("%lu reads per row, one supply\n", (unsigned long)ROUNDS);
+    printf("%8s  %-14s %-4s %10s  %6s  %s\n", "clock", "read", "PEC", "trans/s", "bytes", "failed");
+    const uint32_t clocks[] = { 100000, 400000 };
+    for (uint8_t c = 0; c < 2; c++) {
+        for (uint8_t snapshots = 0; snapshots < 2; snapshots++) {
+            run(clocks[c], snapshots != 0, false);
+            run(clocks[c], snapshots != 0, true);
+        }
+    }
+    return 0;
+}
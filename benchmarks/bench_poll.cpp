@@ -0,0 +1,65 @@
+/**
+ *   @file bench_poll.cpp
+ *
+ *  Non-blocking read latency on the simulated bus at 100 kHz and 400 kHz, with
+ *  other work between poll() calls, against a blocking tryReadWord(). Latency is
+ *  from beginRead() to the result; the step is the longest a single call blocked.
+ */
+
+#include <stdio.h>
+#include "RACM600Sim.h"
+
+typedef RACM600Device<RACM600SimBus> Device;
+
+static const uint32_t READS = 1000;
+
+static void run(uint32_t clockHz, int32_t workMicros) {
+    RACM600Simulator sim(clockHz);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    Device psu(0x27, RACM600SimBus(sim));
+    psu.begin();
+
+    uint32_t failures = 0;
+    uint32_t latencySum = 0;
+    uint32_t latencyMax = 0;
+    uint32_t stepMax = 0;
+    for (uint32_t i = 0; i < READS; i++) {
+        uint16_t raw;
+        if (workMicros < 0) {
+            // Blocking read: the whole transaction is one step
+            uint32_t start = sim.micros();
+            if (psu.tryReadWord(RACM600_READ_IOUT, raw) != RACM600_OK) failures++;
+            uint32_t latency = sim.micros() - start;
+            latencySum += latency;
+            if (latency > latencyMax) latencyMax = latency;
+            if (latency > stepMax) stepMax = latency;
+            continue;
+        }
+        psu.resetPollTiming();
+        psu.beginRead(RACM600_READ_IOUT);
+        while (!psu.poll()) sim.advance(workMicros);
+        if (!psu.readResult(raw)) failures++;
+        latencySum += psu.lastTransactionMicros();
+        if (psu.lastTransactionMicros() > latencyMax) latencyMax = psu.lastTransactionMicros();
+        if (psu.maxPollStepMicros() > stepMax) stepMax = psu.maxPollStepMicros();
+    }
+
+    char method[32];
+    if (workMicros < 0) snprintf(method, sizeof(method), "tryReadWord()");
+    else snprintf(method, sizeof(method), "poll(), %ld us work", (long)workMicros);
+    printf("%4lu kHz  %-22s %8.1f  %8lu  %8lu  %lu\n",
+           (unsigned long)(clockHz / 1000), method, latencySum / (double)READS,
+           (unsigned long)latencyMax, (unsigned long)stepMax, (unsigned long)failures);
+}
+
+int main() {
+    printf("%lu READ_IOUT reads per row, one supply\n", (unsigned long)READS);
+    printf("%8s  %-22s %8s  %8s  %8s  %s\n", "clock", "method", "mean us", "max us", "step us", "failed");
+    const uint32_t clocks[] = { 100000, 400000 };
+    const int32_t work[] = { -1, 0, 100, 1000 };
+    for (uint8_t c = 0; c < 2; c++) {
+        for (uint8_t w = 0; w < 4; w++) run(clocks[c], work[w]);
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+/**
+ *   @file bench_retry.cpp
+ *
+ *  Cost of the read retry policy under injected NAKs: failed reads, retries spent and
+ *  bus time per READ_VOUT and per snapshot at 400 kHz, for 0.1%, 1% and 10% NAK rates.
+ */
+
+#include <stdio.h>
+#include "RACM600Sim.h"
+
+typedef RACM600Device<RACM600SimBus> Device;
+
+static const uint32_t READS = 10000;
+
+static void run(float nakRate, uint8_t retries, uint16_t backoffMicros, bool snapshots = false) {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    Device device(0x27, RACM600SimBus(sim));
+    device.begin();
+    device.setRetryPolicy(retries, backoffMicros);
+    sim.setNakRate(nakRate);
+
+    uint32_t failures = 0;
+    uint32_t worst = 0;
+    uint32_t start = sim.micros();
+    for (uint32_t i = 0; i < READS; i++) {
+        int32_t millivolts;
+        RACM600Snapshot snapshot;
+        uint32_t before = sim.micros();
+        if (snapshots ? !device.readSnapshot(snapshot) : device.tryReadVoltage_mV(millivolts) != RACM600_OK) failures++;
+        uint32_t elapsed = sim.micros() - before;
+        if (elapsed > worst) worst = elapsed;
+    }
+    printf("%5.1f%%  %7u  %7u  %8lu  %8lu  %9.1f  %8lu\n",
+           nakRate * 100, retries, backoffMicros, (unsigned long)failures,
+           (unsigned long)device.retries(), (sim.micros() - start) / (double)READS,
+           (unsigned long)worst);
+}
+
+int main() {
+    const float rates[] = { 0.001f, 0.01f, 0.1f };
+    printf("%u READ_VOUT transactions per row, 400 kHz\n", (unsigned)READS);
+    printf("   NAK  retries  backoff  failures   retried  us / read  worst us\n");
+    for (uint8_t r = 0; r < 3; r++) {
+        run(rates[r], 0, 0);
+        run(rates[r], 1, 50);
+        run(rates[r], 3, 50);
+        run(rates[r], 3, 0);
+    }
+    printf("\n%u snapshots per row, 400 kHz\n", (unsigned)READS);
+    printf("   NAK  retries  backoff  failures   retried  us / read  worst us\n");
+    for (uint8_t r = 0; r < 3; r++) {
+        run(rates[r], 0, 0, true);
+        run(rates[r], 3, 50, true);
+    }
+    return 0;
+}
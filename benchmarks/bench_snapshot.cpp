@@ -0,0 +1,68 @@
+/**
+ *   @file bench_snapshot.cpp
+ *
+ *  Snapshot throughput on the simulated bus at 100 kHz and 400 kHz: readSnapshot()
+ *  against the same nine registers read one reader call at a time, and the Main
+ *  plus AUX sweep. Rates are in snapshots per second of bus time.
+ */
+
+#include <stdio.h>
+#include "RACM600Sim.h"
+
+typedef RACM600Device<RACM600SimBus> Device;
+
+static const uint32_t SNAPSHOTS = 1000;
+
+enum Method { BATCH, READERS, SWEEP };
+
+static void run(uint32_t clockHz, Method method, const char* name) {
+    RACM600Simulator sim(clockHz);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    Device psu(0x27, RACM600SimBus(sim));
+    psu.begin();
+
+    uint32_t failures = 0;
+    uint32_t transactions = sim.transactions();
+    uint32_t bytes = sim.bytes();
+    uint32_t start = sim.micros();
+    for (uint32_t i = 0; i < SNAPSHOTS; i++) {
+        RACM600Snapshot snapshot;
+        RACM600AuxSnapshot aux;
+        bool complete = true;
+        if (method == BATCH) {
+            complete = psu.readSnapshot(snapshot);
+        } else if (method == SWEEP) {
+            complete = psu.readSnapshot(snapshot, aux);
+        } else {
+            static const uint8_t commands[] = {
+                RACM600_READ_VOUT, RACM600_READ_IOUT, RACM600_READ_TEMPERATURE_1,
+                RACM600_READ_TEMPERATURE_2, RACM600_READ_TEMPERATURE_3, RACM600_READ_POUT,
+                RACM600_READ_VIN, RACM600_READ_VCAP, RACM600_STATUS_WORD
+            };
+            for (uint8_t c = 0; c < sizeof(commands); c++) {
+                uint16_t raw;
+                if (psu.tryReadWord(commands[c], raw) != RACM600_OK) complete = false;
+            }
+        }
+        if (!complete) failures++;
+    }
+    uint32_t elapsed = sim.micros() - start;
+
+    printf("%4lu kHz  %-22s %8.1f  %8.1f  %6.1f  %6.1f  %lu\n",
+           (unsigned long)(clockHz / 1000), name, elapsed / (double)SNAPSHOTS,
+           SNAPSHOTS * 1e6 / elapsed, (sim.transactions() - transactions) / (double)SNAPSHOTS,
+           (sim.bytes() - bytes) / (double)SNAPSHOTS, (unsigned long)failures);
+}
+
+int main() {
+    printf("%lu snapshots per row, one supply\n", (unsigned long)SNAPSHOTS);
+    printf("%8s  %-22s %8s  %8s  %6s  %6s  %s\n", "clock", "method", "us each", "per sec", "trans", "bytes", "failed");
+    const uint32_t clocks[] = { 100000, 400000 };
+    for (uint8_t c = 0; c < 2; c++) {
+        run(clocks[c], BATCH, "readSnapshot()");
+        run(clocks[c], READERS, "tryReadWord() x 9");
+        run(clocks[c], SWEEP, "Main + AUX sweep");
+    }
+    return 0;
+}
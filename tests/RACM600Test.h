@@ -0,0 +1,49 @@
+/**
+ *   @file RACM600Test.h
+ *
+ *  Minimal check macros for the RACM600 host tests: failures are printed with
+ *  their location and counted, main() returns the count so ctest sees them.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this
+ *  code to support the exploration and documentation of deep-water
+ *  ecosystems, contributing to their conservation and management. To
+ *  sustain our mission and initiatives, please consider donating at
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+
+#ifndef RACM600_TEST_H
+#define RACM600_TEST_H
+
+#include <stdio.h>
+
+static int racm600TestFailures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            racm600TestFailures++; \
+        } \
+    } while (0)
+
+#define CHECK_EQUAL(expected, actual) \
+    do { \
+        long long e_ = (long long)(expected); \
+        long long a_ = (long long)(actual); \
+        if (e_ != a_) { \
+            printf("%s:%d: %s == %lld, expected %lld\n", __FILE__, __LINE__, #actual, a_, e_); \
+            racm600TestFailures++; \
+        } \
+    } while (0)
+
+#define TEST_RESULT() \
+    (printf(racm600TestFailures ? "%d check(s) failed\n" : "all checks passed\n", racm600TestFailures), \
+     racm600TestFailures)
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ *   @file Arduino.h
+ *
+ *  Host stand-in for the Arduino core, just enough of it to build the RACM600
+ *  library with ARDUINO defined. Time, delays and the SMBALERT# pin come from
+ *  the RACM600Simulator attached to Wire (see Wire.h).
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this
+ *  code to support the exploration and documentation of deep-water
+ *  ecosystems, contributing to their conservation and management. To
+ *  sustain our mission and initiatives, please consider donating at
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+
+#ifndef RACM600_HOST_ARDUINO_H
+#define RACM600_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT_PULLUP 2
+#define FALLING 2
+#define NOT_AN_INTERRUPT -1
+#define DEC 10
+#define HEX 16
+
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+#define pgm_read_float(address) (*(const float*)(address))
+#define F(string) (string)
+
+#define lowByte(w) ((uint8_t)((w) & 0xFF))
+#define highByte(w) ((uint8_t)((w) >> 8))
+
+uint32_t micros();
+uint32_t millis();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// Every pin has an interrupt, the one attached fires from hostRaiseInterrupt()
+#define digitalPinToInterrupt(pin) ((int)(pin))
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void attachInterrupt(int interrupt, void (*isr)(void), int mode);
+void detachInterrupt(int interrupt);
+void hostRaiseInterrupt();
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+// Print over a stdio stream
+class Print {
+public:
+    Print(FILE* out = stdout) : _out(out) {}
+
+    size_t print(const char* text) { return fprintf(_out, "%s", text); }
+    size_t print(char c) { return fprintf(_out, "%c", c); }
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(long value, int base = DEC) { return fprintf(_out, base == HEX ? "%lX" : "%ld", value); }
+    size_t print(unsigned long value, int base = DEC) { return fprintf(_out, base == HEX ? "%lX" : "%lu", value); }
+    size_t print(double value, int digits = 2) { return fprintf(_out, "%.*f", digits, value); }
+
+    template <class T>
+    size_t println(T value) { return print(value) + println(); }
+    template <class T>
+    size_t println(T value, int format) { return print(value, format) + println(); }
+    size_t println() { return fprintf(_out, "\n"); }
+
+private:
+    FILE* _out;
+};
+
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,81 @@
+/**
+ *   @file Host.cpp
+ *
+ *  Host stand-ins for the Arduino core and Wire, backed by RACM600SimWire.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this
+ *  code to support the exploration and documentation of deep-water
+ *  ecosystems, contributing to their conservation and management. To
+ *  sustain our mission and initiatives, please consider donating at
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "RACM600Sim.h"
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+static void (*attachedIsr)(void) = NULL;
+
+// Time only moves with the simulated bus, 0 until Wire is attached
+uint32_t micros() {
+    return Wire.attached() ? Wire.attached()->simulator().micros() : 0;
+}
+
+uint32_t millis() {
+    return micros() / 1000;
+}
+
+void delay(unsigned long ms) {
+    if (Wire.attached()) Wire.attached()->simulator().advance(ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+    if (Wire.attached()) Wire.attached()->simulator().advance(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    (void)pin;
+    (void)mode;
+}
+
+// Every pin reads SMBALERT# of the attached bus
+int digitalRead(uint8_t pin) {
+    (void)pin;
+    return Wire.attached() && Wire.attached()->simulator().alertAsserted() ? LOW : HIGH;
+}
+
+void attachInterrupt(int interrupt, void (*isr)(void), int mode) {
+    (void)interrupt;
+    (void)mode;
+    attachedIsr = isr;
+}
+
+void detachInterrupt(int interrupt) {
+    (void)interrupt;
+    attachedIsr = NULL;
+}
+
+// Runs the attached interrupt handler, as a falling edge on its pin would
+void hostRaiseInterrupt() {
+    if (attachedIsr) attachedIsr();
+}
+
+void TwoWire::attach(RACM600SimWire& wire) { _wire = &wire; }
+void TwoWire::begin() { _wire->begin(); }
+void TwoWire::setClock(uint32_t hz) { _wire->setClock(hz); }
+void TwoWire::beginTransmission(uint8_t address) { _wire->beginTransmission(address); }
+size_t TwoWire::write(uint8_t value) { return _wire->write(value); }
+size_t TwoWire::write(const uint8_t* data, size_t length) { return _wire->write(data, length); }
+uint8_t TwoWire::endTransmission(bool stop) { return _wire->endTransmission(stop); }
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t stop) { return _wire->requestFrom(address, quantity, stop); }
+int TwoWire::available() { return _wire->available(); }
+int TwoWire::read() { return _wire->read(); }
@@ -0,0 +1,52 @@
+/**
+ *   @file Wire.h
+ *
+ *  Host stand-in for the Arduino Wire library. TwoWire forwards every call to
+ *  the RACM600SimWire given to attach(), so sketches and the library's
+ *  RACM600WireBus run unchanged against simulated supplies.
+ *
+ *  Marine Applied Research & Exploration (MARE) develops and shares this
+ *  code to support the exploration and documentation of deep-water
+ *  ecosystems, contributing to their conservation and management. To
+ *  sustain our mission and initiatives, please consider donating at
+ *  https://maregroup.org/donate.
+ *
+ *  Created by Isaac Assegai Travers for Marine Applied Research & Exploration.
+ *
+ *  This library is distributed under the BSD license. Redistribution must
+ *  retain this notice and accompanying license text.
+ */
+
+
+#ifndef RACM600_HOST_WIRE_H
+#define RACM600_HOST_WIRE_H
+
+#include <Arduino.h>
+
+class RACM600SimWire;
+
+class TwoWire {
+public:
+    TwoWire() : _wire(NULL) {}
+
+    // Routes this Wire, and the host micros()/delay() clock, to a simulated bus
+    void attach(RACM600SimWire& wire);
+    RACM600SimWire* attached() const { return _wire; }
+
+    void begin();
+    void setClock(uint32_t hz);
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t value);
+    size_t write(const uint8_t* data, size_t length);
+    uint8_t endTransmission(bool stop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t stop = 1);
+    int available();
+    int read();
+
+private:
+    RACM600SimWire* _wire;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,87 @@
+/**
+ *   @file test_adaptive.cpp
+ *
+ *  RACM600AdaptivePoller::begin(): VOUT_MODE is read with the limits, and
+ *  begin() fails while it is unknown.
+ */
+
+#include "RACM600Sim.h"
+#include "RACM600Adaptive.h"
+#include "RACM600Test.h"
+
+// Simulated bus that fails the next reads of one command
+class FlakyBus : public RACM600SimBus {
+public:
+    FlakyBus() : _command(0), _failures(0) {}
+    FlakyBus(RACM600Simulator& sim) : RACM600SimBus(sim), _command(0), _failures(0) {}
+
+    void fail(uint8_t command, uint8_t reads) {
+        _command = command;
+        _failures = reads;
+    }
+
+    bool writeRead(uint8_t address, const uint8_t* out, uint8_t outLength, uint8_t* in, uint8_t inLength) {
+        if (outLength == 1 && out[0] == _command && _failures > 0) {
+            _failures--;
+            return false;
+        }
+        return RACM600SimBus::writeRead(address, out, outLength, in, inLength);
+    }
+
+private:
+    uint8_t _command;
+    uint8_t _failures;
+};
+
+typedef RACM600Device<FlakyBus> Device;
+typedef RACM600AdaptivePoller<FlakyBus> Poller;
+
+// Without VOUT_MODE the VOUT limit cannot be decoded, so begin() fails and tick() stays idle
+static void testBeginFailsWithoutVoutMode() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    Device psu(0x27, FlakyBus(sim));
+    psu.begin();                                // Nobody on the bus yet
+    sim.attach(supply);
+
+    Poller poller(psu);
+    psu.bus().fail(RACM600_VOUT_MODE, 1);
+    CHECK(!poller.begin());
+    CHECK_EQUAL(0, poller.tick());
+    CHECK(!poller.sampled(RACM600_ADAPT_VOUT));
+
+    // A later begin() reads it and the limits
+    CHECK(poller.begin());
+    CHECK_EQUAL(0x17, psu.voutMode());
+    CHECK_EQUAL(14500, poller.limit(RACM600_ADAPT_VOUT));
+    CHECK_EQUAL(52000, poller.limit(RACM600_ADAPT_IOUT));
+    CHECK_EQUAL(10000, poller.limit(RACM600_ADAPT_TEMPERATURE_1));
+    CHECK_EQUAL(5, poller.tick());
+    CHECK_EQUAL(12000, poller.value(RACM600_ADAPT_VOUT));
+}
+
+// A VOUT_MODE read that fails after the device's begin() read it still fails begin(),
+// rather than decoding with the value cached earlier
+static void testBeginRereadsVoutMode() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    Device psu(0x27, FlakyBus(sim));
+    psu.begin();
+
+    Poller poller(psu);
+    psu.bus().fail(RACM600_VOUT_MODE, 1);
+    CHECK(!poller.begin());
+
+    // The supply now reports exponent -10, the raw limit word stands for half the voltage
+    supply.setReg(RACM600_VOUT_MODE, 0x16);
+    CHECK(poller.begin());
+    CHECK_EQUAL(0x16, psu.voutMode());
+    CHECK_EQUAL(7250, poller.limit(RACM600_ADAPT_VOUT));
+}
+
+int main() {
+    testBeginFailsWithoutVoutMode();
+    testBeginRereadsVoutMode();
+    return TEST_RESULT();
+}
@@ -0,0 +1,87 @@
+/**
+ *   @file test_alert.cpp
+ *
+ *  SMBALERT# servicing in the Arduino build: the interrupt queue, the ARA read
+ *  that releases the line, and a second fault raising a second event, for
+ *  one supply and for several sharing the line.
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "RACM600.h"
+#include "RACM600Sim.h"
+#include "RACM600Test.h"
+
+static const uint8_t ALERT_PIN = 2;
+
+static RACM600Simulator sim(100000);
+static RACM600SimWire simWire(sim);
+static RACM600SimDevice first(0x27);
+static RACM600SimDevice second(0x28);
+
+// Latches a fault, with the falling edge only a released line can give
+static void raise(RACM600SimDevice& supply, uint8_t statusCommand, uint8_t bits) {
+    bool released = digitalRead(ALERT_PIN) == HIGH;
+    supply.raiseFault(statusCommand, bits);
+    if (released && digitalRead(ALERT_PIN) == LOW) hostRaiseInterrupt();
+}
+
+static void testSingleSupply(RACM600& psu) {
+    RACM600FaultReport report;
+    CHECK(!psu.serviceAlert(report));
+
+    raise(first, RACM600_STATUS_CML, 0x80);
+    CHECK(RACM600Alert::pending());
+    CHECK(psu.serviceAlert(report));
+    CHECK_EQUAL(0x80, report.detail[RACM600_DETAIL_CML]);
+    CHECK_EQUAL(HIGH, digitalRead(ALERT_PIN));     // Released by the ARA read
+    CHECK(!psu.serviceAlert(report));
+
+    raise(first, RACM600_STATUS_TEMPERATURE, 0x40);
+    CHECK(psu.serviceAlert(report));
+    CHECK_EQUAL(0x40, report.detail[RACM600_DETAIL_TEMPERATURE]);
+    CHECK_EQUAL(0x0004, report.changed);
+    CHECK(!psu.serviceAlert(report));
+    CHECK_EQUAL(0, RACM600Alert::dropped());
+    psu.clearFaults();
+}
+
+// Two supplies alerting on one edge are serviced lowest address first, then a later fault
+// raises its own edge
+static void testSharedLine(RACM600& psu, RACM600& other) {
+    RACM600* bank[] = { &psu, &other };
+    RACM600FaultReport report;
+
+    raise(second, RACM600_STATUS_CML, 0x80);
+    raise(first, RACM600_STATUS_CML, 0x40);
+    CHECK(RACM600::serviceAlert(bank, 2, report) == &psu);
+    CHECK_EQUAL(0x40, report.detail[RACM600_DETAIL_CML]);
+    CHECK_EQUAL(LOW, digitalRead(ALERT_PIN));      // The other supply still holds it
+    CHECK(RACM600::serviceAlert(bank, 2, report) == &other);
+    CHECK_EQUAL(0x80, report.detail[RACM600_DETAIL_CML]);
+    CHECK(RACM600::serviceAlert(bank, 2, report) == NULL);
+
+    raise(second, RACM600_STATUS_TEMPERATURE, 0x40);
+    CHECK(RACM600::serviceAlert(bank, 2, report) == &other);
+    CHECK_EQUAL(0x40, report.detail[RACM600_DETAIL_TEMPERATURE]);
+    CHECK(RACM600::serviceAlert(bank, 2, report) == NULL);
+}
+
+int main() {
+    sim.attach(first);
+    sim.attach(second);
+    Wire.attach(simWire);
+
+    RACM600 psu(0x27);
+    RACM600 other(0x28);
+    Wire.begin();
+    psu.begin();
+    other.begin();
+    CHECK(RACM600Alert::attach(ALERT_PIN));
+
+    testSingleSupply(psu);
+    testSharedLine(psu, other);
+    RACM600Alert::detach();
+    return TEST_RESULT();
+}
@@ -0,0 +1,137 @@
+/**
+ *   @file test_bank.cpp
+ *
+ *  RACM600Bank tick scheduling: the per-tick budget, round robin fairness
+ *  across ticks, failed reads, staleness, and starting the shared bus once.
+ */
+
+#include "RACM600Sim.h"
+#include "RACM600Bank.h"
+#include "RACM600Test.h"
+
+#define SUPPLIES 5
+
+// Simulated bus that counts begin() calls across every copy
+class CountingBus : public RACM600SimBus {
+public:
+    CountingBus() {}
+    CountingBus(RACM600Simulator& sim) : RACM600SimBus(sim) {}
+
+    void begin() { begins++; }
+
+    static uint8_t begins;
+};
+
+uint8_t CountingBus::begins = 0;
+
+typedef RACM600Bank<SUPPLIES, CountingBus> Bank;
+
+struct Rig {
+    RACM600Simulator sim;
+    RACM600SimDevice supplies[SUPPLIES];
+    uint8_t addresses[SUPPLIES];
+    Bank bank;
+
+    Rig(uint32_t budget, uint8_t attached = SUPPLIES)
+        : sim(400000), bank(addressList(), SUPPLIES, budget, CountingBus(sim)) {
+        for (uint8_t i = 0; i < attached; i++) {
+            supplies[i] = RACM600SimDevice(addresses[i]);
+            sim.attach(supplies[i]);
+        }
+        bank.begin();
+    }
+
+    const uint8_t* addressList() {
+        for (uint8_t i = 0; i < SUPPLIES; i++) addresses[i] = 0x20 + i;
+        return addresses;
+    }
+
+    // Bus time of one Page 0 snapshot with the page already selected
+    uint32_t snapshotMicros() {
+        RACM600Snapshot snapshot;
+        bank.device(0).readSnapshot(snapshot);
+        uint32_t start = sim.micros();
+        bank.device(0).readSnapshot(snapshot);
+        return sim.micros() - start;
+    }
+};
+
+static void testBeginStartsBusOnce() {
+    CountingBus::begins = 0;
+    Rig rig(1000);
+    CHECK_EQUAL(1, CountingBus::begins);
+    for (uint8_t i = 0; i < SUPPLIES; i++) {
+        CHECK_EQUAL(0x17, rig.bank.device(i).voutMode());
+    }
+}
+
+// A budget of two and a half snapshots reads two per tick, and the cursor carries over
+// so each supply is read once per rotation
+static void testBudgetAndRotation() {
+    Rig probe(0);
+    uint32_t snapshot = probe.snapshotMicros();
+
+    Rig rig(snapshot * 5 / 2);
+    CHECK_EQUAL(2, rig.bank.tick());
+    CHECK_EQUAL(2, rig.bank.tick());
+    CHECK_EQUAL(2, rig.bank.tick());           // Supply 4, then supply 0 again
+    const uint32_t expected[] = { 2, 1, 1, 1, 1 };
+    for (uint8_t i = 0; i < SUPPLIES; i++) {
+        CHECK_EQUAL(expected[i], rig.bank.samples(i));
+    }
+
+    for (uint8_t t = 0; t < 17; t++) rig.bank.tick();   // 40 reads in all, 8 rotations
+    for (uint8_t i = 0; i < SUPPLIES; i++) {
+        CHECK_EQUAL(8, rig.bank.samples(i));
+    }
+}
+
+// A budget below one snapshot still reads one supply per tick, a large one reads each
+// supply once and no more
+static void testBudgetExtremes() {
+    Rig tight(1);
+    for (uint8_t t = 0; t < SUPPLIES; t++) CHECK_EQUAL(1, tight.bank.tick());
+    for (uint8_t i = 0; i < SUPPLIES; i++) CHECK_EQUAL(1, tight.bank.samples(i));
+
+    Rig loose(1000000);
+    CHECK_EQUAL(SUPPLIES, loose.bank.tick());
+    for (uint8_t i = 0; i < SUPPLIES; i++) CHECK_EQUAL(1, loose.bank.samples(i));
+}
+
+// A supply that does not answer is counted as failed, keeps no sample, and does not
+// stall the rotation
+static void testFailedSupply() {
+    Rig rig(1000000, SUPPLIES - 1);
+    CHECK_EQUAL(SUPPLIES, rig.bank.tick());
+    CHECK_EQUAL(SUPPLIES, rig.bank.tick());
+    CHECK_EQUAL(2, rig.bank.failures(SUPPLIES - 1));
+    CHECK(!rig.bank.hasSample(SUPPLIES - 1));
+    CHECK_EQUAL(0xFFFFFFFFUL, rig.bank.staleness(SUPPLIES - 1));
+    for (uint8_t i = 0; i < SUPPLIES - 1; i++) {
+        CHECK_EQUAL(2, rig.bank.samples(i));
+        CHECK_EQUAL(0, rig.bank.failures(i));
+    }
+}
+
+// Staleness is the age of the last successful snapshot, the oldest across the bank
+static void testStaleness() {
+    Rig rig(1);
+    rig.bank.tick();
+    rig.sim.advance(5000);
+    CHECK(rig.bank.staleness(0) > 5000);
+    CHECK_EQUAL(0xFFFFFFFFUL, rig.bank.maxStaleness());     // Supply 1 not read yet
+
+    for (uint8_t t = 1; t < SUPPLIES; t++) rig.bank.tick();
+    CHECK_EQUAL(rig.bank.staleness(0), rig.bank.maxStaleness());
+    CHECK(rig.bank.staleness(SUPPLIES - 1) < rig.bank.staleness(0));
+    CHECK_EQUAL(rig.sim.micros() - rig.bank.snapshot(0).timestamp, rig.bank.staleness(0));
+}
+
+int main() {
+    testBeginStartsBusOnce();
+    testBudgetAndRotation();
+    testBudgetExtremes();
+    testFailedSupply();
+    testStaleness();
+    return TEST_RESULT();
+}
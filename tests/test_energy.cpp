@@ -0,0 +1,91 @@
+/**
+ *   @file test_energy.cpp
+ *
+ *  RACM600Energy: trapezoid sums against closed-form values, intervals across
+ *  a micros() wrap, and intervals beyond the maximum gap.
+ */
+
+#include "RACM600Energy.h"
+#include "RACM600Test.h"
+
+// A linear ramp integrates exactly: 0 to 600 W over 1 s is 300 J
+static void testLinearRamp() {
+    RACM600Energy energy;
+    for (uint32_t k = 0; k <= 1000; k++) {
+        energy.add(k * 1000, 600 * k);
+    }
+    CHECK_EQUAL(300000000000LL, energy.nanojoules());
+    CHECK_EQUAL(300, energy.joules());
+    CHECK_EQUAL(83, energy.milliwattHours());         // 300 J is 83.3 mWh
+    CHECK_EQUAL(1000000, energy.integratedMicros());
+    CHECK_EQUAL(300000, energy.averagePower_mW());
+    CHECK_EQUAL(1001, energy.samples());
+}
+
+// For P_k = k^2 mW every h us the trapezoid sum is h * (n(n+1)(2n+1)/6 - n^2/2)
+static void testQuadraticSum() {
+    const int64_t n = 1000;
+    const int64_t h = 1000;
+    RACM600Energy energy;
+    for (int64_t k = 0; k <= n; k++) {
+        energy.add((uint32_t)(k * h), (int32_t)(k * k));
+    }
+    CHECK_EQUAL(h * (n * (n + 1) * (2 * n + 1) / 6 - n * n / 2), energy.nanojoules());
+}
+
+// Intervals are taken modulo 2^32, so a series across the micros() wrap is unbroken
+static void testMicrosWrap() {
+    RACM600Energy energy;
+    energy.add(0xFFFFFF00UL, 1000);
+    energy.add(0x00000100UL, 1000);                     // 512 us later
+    CHECK_EQUAL(512000, energy.nanojoules());
+    CHECK_EQUAL(512, energy.integratedMicros());
+    CHECK_EQUAL(0, energy.gaps());
+
+    // One sample a second for two hours, past the 71.6 minute wrap
+    energy.reset();
+    uint32_t timestamp = 0xFFFFFFFFUL - 1800000000UL;
+    for (uint32_t s = 0; s <= 7200; s++, timestamp += 1000000UL) {
+        energy.add(timestamp, 250000);
+    }
+    CHECK_EQUAL(7200LL * 250 * 1000000000LL, energy.nanojoules());
+    CHECK_EQUAL(7200000000ULL, energy.integratedMicros());
+    CHECK_EQUAL(500, energy.milliwattHours() / 1000);   // 250 W for 2 h
+    CHECK_EQUAL(0, energy.gaps());
+}
+
+// An interval longer than the maximum gap is counted instead of integrated, one exactly as
+// long is integrated, and the series carries on after it
+static void testMaxGap() {
+    RACM600Energy energy;
+    CHECK_EQUAL(RACM600_ENERGY_MAX_GAP_MICROS, energy.maxGap());
+    energy.setMaxGap(1000);
+    CHECK_EQUAL(1000, energy.maxGap());
+
+    energy.add(0, 2000);
+    energy.add(1000, 2000);         // Exactly the maximum, integrated
+    energy.add(3001, 2000);         // 2001 us, skipped
+    energy.add(3501, 4000);
+    CHECK_EQUAL(2000000 + 1500000, energy.nanojoules());
+    CHECK_EQUAL(1500, energy.integratedMicros());
+    CHECK_EQUAL(1, energy.gaps());
+    CHECK_EQUAL(2001, energy.gapMicros());
+    CHECK_EQUAL(2333, energy.averagePower_mW());
+
+    // A gap across the wrap is measured modulo 2^32 as well
+    energy.reset();
+    energy.add(0xFFFFF000UL, 1000);
+    energy.add(0x00001000UL, 1000);
+    CHECK_EQUAL(0, energy.nanojoules());
+    CHECK_EQUAL(1, energy.gaps());
+    CHECK_EQUAL(0x2000, energy.gapMicros());
+    CHECK_EQUAL(0, energy.averagePower_mW());
+}
+
+int main() {
+    testLinearRamp();
+    testQuadraticSum();
+    testMicrosWrap();
+    testMaxGap();
+    return TEST_RESULT();
+}
@@ -0,0 +1,31 @@
+/**
+ *   @file test_example.cpp
+ *
+ *  Builds the unmodified example sketch against the host Arduino core and
+ *  runs setup() and a few loop() passes on a simulated supply.
+ */
+
+#include <Arduino.h>
+
+#include "RACM600Sim.h"
+#include "RACM600Test.h"
+
+#include "../examples/RACM600_Example/RACM600_Example.ino"
+
+int main() {
+    RACM600Simulator sim(100000);
+    RACM600SimWire simWire(sim);
+    RACM600SimDevice supply(RACM600_DEFAULT_ADDR);
+    sim.attach(supply);
+    Wire.attach(simWire);
+
+    supply.setReg(RACM600_OPERATION, 0x00);
+    setup();
+    CHECK(supply.outputOn());
+    for (uint8_t i = 0; i < 3; i++) {
+        loop();
+    }
+    CHECK(millis() >= 3500);    // setup() and each loop() wait on the simulated clock
+    CHECK(sim.transactions() > 15);
+    return TEST_RESULT();
+}
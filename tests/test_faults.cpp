@@ -0,0 +1,176 @@
+/**
+ *   @file test_faults.cpp
+ *
+ *  Edge-triggered fault reports: cached detail registers, the changed mask,
+ *  and recovery from reads that fail.
+ */
+
+#include "RACM600Sim.h"
+#include "RACM600Test.h"
+
+// Simulated bus that fails the next reads of one command
+class FlakyBus : public RACM600SimBus {
+public:
+    FlakyBus() : _command(0), _failures(0) {}
+    FlakyBus(RACM600Simulator& sim) : RACM600SimBus(sim), _command(0), _failures(0) {}
+
+    void fail(uint8_t command, uint8_t reads) {
+        _command = command;
+        _failures = reads;
+    }
+
+    bool writeRead(uint8_t address, const uint8_t* out, uint8_t outLength, uint8_t* in, uint8_t inLength) {
+        if (outLength == 1 && out[0] == _command && _failures > 0) {
+            _failures--;
+            return false;
+        }
+        return RACM600SimBus::writeRead(address, out, outLength, in, inLength);
+    }
+
+private:
+    uint8_t _command;
+    uint8_t _failures;
+};
+
+typedef RACM600Device<FlakyBus> Device;
+
+// A fault that stays latched costs one STATUS_WORD read per poll
+static void testLatchedFaultCostsOneRead() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    Device psu(0x27, FlakyBus(sim));
+    psu.begin();
+
+    supply.setTemperature(1, 105.0f);
+    RACM600FaultReport report;
+    CHECK_EQUAL(RACM600_OK, psu.tryReadFaults(report));
+    CHECK_EQUAL(0x0004, report.changed);
+    CHECK_EQUAL(0x40, report.detail[RACM600_DETAIL_TEMPERATURE]);
+
+    uint32_t transactions = sim.transactions();
+    CHECK_EQUAL(RACM600_OK, psu.tryReadFaults(report));
+    CHECK_EQUAL(1, sim.transactions() - transactions);
+    CHECK_EQUAL(0, report.changed);
+    CHECK_EQUAL(0x40, report.detail[RACM600_DETAIL_TEMPERATURE]);
+}
+
+// A detail register that fails to read is read again on the next poll
+static void testFailedDetailIsReread() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    Device psu(0x27, FlakyBus(sim));
+    psu.begin();
+
+    supply.setTemperature(1, 105.0f);
+    psu.bus().fail(RACM600_STATUS_TEMPERATURE, 1);
+    RACM600FaultReport report;
+    CHECK_EQUAL(RACM600_BUS_ERROR, psu.tryReadFaults(report));
+    CHECK(report.statusWord & 0x0004);
+    CHECK_EQUAL(0, report.detail[RACM600_DETAIL_TEMPERATURE]);
+
+    CHECK_EQUAL(RACM600_OK, psu.tryReadFaults(report));
+    CHECK_EQUAL(0, report.changed);     // The summary bit itself did not change
+    CHECK_EQUAL(0x40, report.detail[RACM600_DETAIL_TEMPERATURE]);
+
+    uint32_t transactions = sim.transactions();
+    psu.readFaults(report);
+    CHECK_EQUAL(1, sim.transactions() - transactions);
+    CHECK_EQUAL(0x40, report.detail[RACM600_DETAIL_TEMPERATURE]);
+}
+
+// A failed STATUS_WORD read keeps the previous report and reports nothing as changed
+static void testFailedStatusWordKeepsReport() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    Device psu(0x27, FlakyBus(sim));
+    psu.begin();
+
+    supply.setCurrent(53.0f);
+    RACM600FaultReport report;
+    CHECK_EQUAL(RACM600_OK, psu.tryReadFaults(report));
+    uint16_t latched = report.statusWord;
+    CHECK(latched & 0x4000);
+
+    psu.bus().fail(RACM600_STATUS_WORD, 1);
+    CHECK_EQUAL(RACM600_BUS_ERROR, psu.tryReadFaults(report));
+    CHECK_EQUAL(RACM600_BUS_ERROR, psu.lastStatus());
+    CHECK_EQUAL(latched, report.statusWord);
+    CHECK_EQUAL(0, report.changed);
+    CHECK_EQUAL(0x20, report.detail[RACM600_DETAIL_IOUT]);
+
+    CHECK_EQUAL(latched, psu.readFaults(report));
+    CHECK_EQUAL(0, report.changed);     // Not reported as newly set after the failure
+
+    // readFaults() without a previous report returns an empty one
+    Device fresh(0x27, FlakyBus(sim));
+    fresh.bus().fail(RACM600_STATUS_WORD, 1);
+    CHECK_EQUAL(0, fresh.readFaults(report));
+    CHECK_EQUAL(0, report.changed);
+}
+
+// Bits that clear are reported in changed and their detail drops to 0
+static void testClearedFault() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    Device psu(0x27, FlakyBus(sim));
+    psu.begin();
+
+    supply.setCurrent(53.0f);
+    RACM600FaultReport report;
+    psu.readFaults(report);
+    supply.setCurrent(10.0f);
+    supply.setReg(RACM600_STATUS_IOUT, 0);  // Cleared by the supply, not through clearFaults()
+    CHECK_EQUAL(0, psu.readFaults(report));
+    CHECK_EQUAL(0x4010, report.changed);
+    CHECK_EQUAL(0, report.detail[RACM600_DETAIL_IOUT]);
+}
+
+// STATUS_WORD and friends are paged, fault reports read the Main page even after an AUX read
+static void testFaultsReadMainPage() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    Device psu(0x27, FlakyBus(sim));
+    psu.begin();
+
+    supply.setCurrent(3.2f, RACM600_PAGE_AUX);     // Past the AUX warning limit only
+    RACM600AuxSnapshot aux;
+    CHECK(psu.readAuxSnapshot(aux));
+    CHECK_EQUAL(RACM600_PAGE_AUX, supply.page());
+
+    RACM600FaultReport report;
+    CHECK_EQUAL(RACM600_OK, psu.tryReadFaults(report));
+    CHECK_EQUAL(RACM600_PAGE_MAIN, supply.page());
+    CHECK_EQUAL(0, report.statusWord);
+    CHECK_EQUAL(0, report.detail[RACM600_DETAIL_IOUT]);
+
+    CHECK(psu.readAuxSnapshot(aux));
+    CHECK_EQUAL(0, psu.checkHealth(report));
+    CHECK_EQUAL(RACM600_PAGE_MAIN, supply.page());
+
+    uint16_t statusWord = 0;
+    uint8_t statusIout = 0;
+    CHECK_EQUAL(RACM600_OK, psu.tryReadWord(RACM600_STATUS_WORD, RACM600_PAGE_AUX, statusWord));
+    CHECK_EQUAL(0x4010, statusWord & 0x4010);
+    CHECK_EQUAL(RACM600_OK, psu.tryReadByte(RACM600_STATUS_IOUT, RACM600_PAGE_AUX, statusIout));
+    CHECK_EQUAL(0x20, statusIout);
+
+    // CLEAR_FAULTS clears both pages once the condition is gone
+    supply.setCurrent(1.0f, RACM600_PAGE_AUX);
+    psu.clearFaults();
+    CHECK_EQUAL(RACM600_OK, psu.tryReadWord(RACM600_STATUS_WORD, RACM600_PAGE_AUX, statusWord));
+    CHECK_EQUAL(0, statusWord);
+}
+
+int main() {
+    testLatchedFaultCostsOneRead();
+    testFailedDetailIsReread();
+    testFailedStatusWordKeepsReport();
+    testClearedFault();
+    testFaultsReadMainPage();
+    return TEST_RESULT();
+}
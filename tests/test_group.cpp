@@ -0,0 +1,195 @@
+/**
+ *   @file test_group.cpp
+ *
+ *  PMBus Group Command framing on the wire: one START, a repeated START and
+ *  address segment per supply, one STOP, and every supply acting at that STOP.
+ */
+
+#include "RACM600Sim.h"
+#include "RACM600Test.h"
+
+typedef RACM600Device<RACM600SimBus> Device;
+
+#define S   RACM600_SIM_START
+#define SR  RACM600_SIM_RESTART
+#define P   RACM600_SIM_STOP
+#define NAK RACM600_SIM_NAK
+
+static void checkTrace(const uint16_t* expected, uint16_t length, const uint16_t* trace, uint16_t traceLength) {
+    CHECK_EQUAL(length, traceLength);
+    for (uint16_t i = 0; i < length && i < traceLength; i++) {
+        if (expected[i] != trace[i]) {
+            printf("trace[%u] == 0x%03X, expected 0x%03X\n", i, trace[i], expected[i]);
+            CHECK_EQUAL(expected[i], trace[i]);
+        }
+    }
+}
+
+struct Bank {
+    RACM600Simulator sim;
+    RACM600SimDevice supplies[3];
+    Device devices[3];
+    Device* pointers[3];
+
+    Bank() : sim(400000) {
+        for (uint8_t i = 0; i < 3; i++) {
+            supplies[i] = RACM600SimDevice(0x20 + i);
+            sim.attach(supplies[i]);
+            devices[i] = Device(0x20 + i, RACM600SimBus(sim));
+            devices[i].setPage(RACM600_PAGE_MAIN);  // Group writes below need no PAGE first
+            pointers[i] = &devices[i];
+        }
+    }
+};
+
+static void testOperationFraming() {
+    Bank bank;
+    uint16_t trace[64];
+    bank.sim.setTrace(trace, 64);
+
+    uint32_t transactions = bank.sim.transactions();
+    CHECK(Device::groupDisableOutput(bank.pointers, 3));
+    const uint16_t expected[] = {
+        S,  0x40, RACM600_OPERATION, 0x00,
+        SR, 0x42, RACM600_OPERATION, 0x00,
+        SR, 0x44, RACM600_OPERATION, 0x00,
+        P
+    };
+    checkTrace(expected, sizeof(expected) / sizeof(expected[0]), trace, bank.sim.traceLength());
+    CHECK_EQUAL(1, bank.sim.transactions() - transactions);
+    for (uint8_t i = 0; i < 3; i++) {
+        CHECK(!bank.supplies[i].outputOn());
+        CHECK_EQUAL(2, bank.supplies[i].writes());  // PAGE, then OPERATION
+    }
+}
+
+// Each segment carries the PEC of its own address, command and data
+static void testPecPerSegment() {
+    Bank bank;
+    for (uint8_t i = 0; i < 3; i++) bank.devices[i].setPec(true);
+    uint16_t trace[64];
+    bank.sim.setTrace(trace, 64);
+
+    CHECK(Device::groupDisableOutput(bank.pointers, 3));
+    const uint16_t expected[] = {
+        S,  0x40, RACM600_OPERATION, 0x00, 0x93,
+        SR, 0x42, RACM600_OPERATION, 0x00, 0x45,
+        SR, 0x44, RACM600_OPERATION, 0x00, 0x38,
+        P
+    };
+    checkTrace(expected, sizeof(expected) / sizeof(expected[0]), trace, bank.sim.traceLength());
+    for (uint8_t i = 0; i < 3; i++) {
+        CHECK(!bank.supplies[i].outputOn());
+    }
+}
+
+// Word data goes out low byte first
+static void testWordFraming() {
+    Bank bank;
+    uint16_t trace[64];
+    bank.sim.setTrace(trace, 64);
+
+    uint16_t limit = RACM600Linear::encodeLinear11Scaled(40000, 1000);
+    CHECK(Device::groupWriteCommand(bank.pointers, 3, RACM600_IOUT_OC_WARN_LIMIT, limit));
+    const uint16_t expected[] = {
+        S,  0x40, RACM600_IOUT_OC_WARN_LIMIT, lowByte(limit), highByte(limit),
+        SR, 0x42, RACM600_IOUT_OC_WARN_LIMIT, lowByte(limit), highByte(limit),
+        SR, 0x44, RACM600_IOUT_OC_WARN_LIMIT, lowByte(limit), highByte(limit),
+        P
+    };
+    checkTrace(expected, sizeof(expected) / sizeof(expected[0]), trace, bank.sim.traceLength());
+    for (uint8_t i = 0; i < 3; i++) {
+        CHECK_EQUAL(limit, bank.supplies[i].reg(RACM600_IOUT_OC_WARN_LIMIT));
+    }
+}
+
+// Bus time is one transaction whatever the bank size: 16 segments of START, address,
+// command and data, then one STOP
+static void testSixteenSupplies() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supplies[16];
+    Device devices[16];
+    Device* pointers[16];
+    for (uint8_t i = 0; i < 16; i++) {
+        supplies[i] = RACM600SimDevice(0x10 + i);
+        sim.attach(supplies[i]);
+        devices[i] = Device(0x10 + i, RACM600SimBus(sim));
+        devices[i].setPage(RACM600_PAGE_MAIN);
+        pointers[i] = &devices[i];
+    }
+
+    uint32_t transactions = sim.transactions();
+    uint32_t start = sim.micros();
+    CHECK(Device::groupDisableOutput(pointers, 16));
+    CHECK_EQUAL(1, sim.transactions() - transactions);
+    CHECK_EQUAL((16 * 28 + 1) * 10 / 4, sim.micros() - start);  // 2.5 us per bit at 400 kHz
+    for (uint8_t i = 0; i < 16; i++) {
+        CHECK(!supplies[i].outputOn());
+    }
+}
+
+// A supply that does not answer its PAGE write fails the group and is left out of it, so
+// the others still switch together
+static void testMissingSupply() {
+    Bank bank;
+    bank.devices[1] = Device(0x30, RACM600SimBus(bank.sim));
+    uint16_t trace[64];
+    bank.sim.setTrace(trace, 64);
+
+    CHECK(!Device::groupDisableOutput(bank.pointers, 3));
+    const uint16_t expected[] = {
+        S,  0x60, NAK, P,
+        S,  0x40, RACM600_OPERATION, 0x00,
+        SR, 0x44, RACM600_OPERATION, 0x00,
+        P
+    };
+    checkTrace(expected, sizeof(expected) / sizeof(expected[0]), trace, bank.sim.traceLength());
+    CHECK(!bank.supplies[0].outputOn());
+    CHECK(bank.supplies[1].outputOn());
+    CHECK(!bank.supplies[2].outputOn());
+}
+
+// OPERATION is paged: a supply left on Page 1 gets PAGE 0 in a transaction of its own before
+// the Group Command, and its AUX output is untouched
+static void testOperationSelectsMainPage() {
+    Bank bank;
+    CHECK(bank.devices[1].setPage(RACM600_PAGE_AUX));
+    uint16_t trace[64];
+    bank.sim.setTrace(trace, 64);
+
+    CHECK(Device::groupDisableOutput(bank.pointers, 3));
+    const uint16_t expected[] = {
+        S,  0x42, RACM600_PAGE, RACM600_PAGE_MAIN, P,
+        S,  0x40, RACM600_OPERATION, 0x00,
+        SR, 0x42, RACM600_OPERATION, 0x00,
+        SR, 0x44, RACM600_OPERATION, 0x00,
+        P
+    };
+    checkTrace(expected, sizeof(expected) / sizeof(expected[0]), trace, bank.sim.traceLength());
+    for (uint8_t i = 0; i < 3; i++) {
+        CHECK(!bank.supplies[i].outputOn());
+        CHECK(bank.supplies[i].outputOn(RACM600_PAGE_AUX));
+        CHECK_EQUAL(0x0840, bank.supplies[i].statusWord() & 0x0840);
+        CHECK_EQUAL(0, bank.supplies[i].statusWord(RACM600_PAGE_AUX) & 0x0840);
+    }
+
+    // The single supply setters do the same
+    CHECK(bank.devices[0].setPage(RACM600_PAGE_AUX));
+    bank.devices[0].enableOutput();
+    CHECK_EQUAL(RACM600_PAGE_MAIN, bank.supplies[0].page());
+    CHECK(bank.supplies[0].outputOn());
+    CHECK(bank.devices[0].setPage(RACM600_PAGE_AUX));
+    bank.devices[0].disableOutput();
+    CHECK(!bank.supplies[0].outputOn());
+    CHECK(bank.supplies[0].outputOn(RACM600_PAGE_AUX));
+}
+
+int main() {
+    testOperationFraming();
+    testPecPerSegment();
+    testWordFraming();
+    testSixteenSupplies();
+    testMissingSupply();
+    testOperationSelectsMainPage();
+    return TEST_RESULT();
+}
@@ -0,0 +1,97 @@
+/**
+ *   @file test_history.cpp
+ *
+ *  Streaming statistics: exact means and stable variances over long runs, and
+ *  the cumulative and window statistics of RACM600History.
+ */
+
+#include "RACM600Sim.h"
+#include "RACM600History.h"
+#include "RACM600Test.h"
+
+// A step after a long run moves the mean to the exact midpoint
+static void testLongRunStep() {
+    RACM600Welford stats;
+    for (uint32_t i = 0; i < 100000; i++) stats.add(1000);
+    for (uint32_t i = 0; i < 100000; i++) stats.add(1010);
+    CHECK_EQUAL(200000, stats.count());
+    CHECK_EQUAL(201000000LL, stats.sum());
+    CHECK_EQUAL(1005, stats.mean());
+    CHECK_EQUAL(25, stats.variance());     // 25.0001 exactly
+    CHECK_EQUAL(5, stats.stddev());
+    CHECK_EQUAL(1000, stats.min());
+    CHECK_EQUAL(1010, stats.max());
+}
+
+// A slow ramp, each value held for 10000 samples
+static void testSlowRamp() {
+    RACM600Welford stats;
+    double sum = 0;
+    double squares = 0;
+    for (int32_t value = 1000; value < 1100; value++) {
+        for (uint32_t i = 0; i < 10000; i++) {
+            stats.add(value);
+            sum += value;
+            squares += (double)value * value;
+        }
+    }
+    double n = stats.count();
+    double variance = (squares - sum * sum / n) / (n - 1);
+    CHECK_EQUAL(1000000, stats.count());
+    CHECK_EQUAL(1050, stats.mean());       // 1049.5 rounds away from zero
+    CHECK_EQUAL((long long)(variance + 0.5), stats.variance());
+}
+
+// Negative values round away from zero and the variance matches the textbook value
+static void testNegativeValues() {
+    RACM600Welford stats;
+    const int32_t values[] = { -3, -4, -4, -5 };
+    for (uint8_t i = 0; i < 4; i++) stats.add(values[i]);
+    CHECK_EQUAL(-16, stats.sum());
+    CHECK_EQUAL(-4, stats.mean());
+    CHECK_EQUAL(1, stats.variance());      // 2/3
+
+    stats.add(-5);
+    stats.add(-5);                         // -26 / 6 = -4.33
+    CHECK_EQUAL(-4, stats.mean());
+    stats.reset();
+    stats.add(-3);
+    stats.add(-4);                         // -3.5
+    CHECK_EQUAL(-4, stats.mean());
+    CHECK_EQUAL(0, RACM600Welford().mean());
+}
+
+// Cumulative statistics and windows over snapshots of the simulated supply
+static void testHistory() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    RACM600Device<RACM600SimBus> psu(0x27, RACM600SimBus(sim));
+    psu.begin();
+
+    RACM600History<8> history;
+    for (uint8_t i = 0; i < 20; i++) {
+        supply.setCurrent(10.0f + i);
+        sim.advance(10000);
+        CHECK(history.sample(psu));
+    }
+    CHECK_EQUAL(8, history.size());
+    const RACM600Welford& all = history.stats(RACM600_CH_IOUT);
+    CHECK_EQUAL(20, all.count());
+    CHECK_EQUAL(19500, all.mean());
+    CHECK_EQUAL(10000, all.min());
+    CHECK_EQUAL(29000, all.max());
+
+    RACM600Welford recent = history.window(RACM600_CH_IOUT, 4);
+    CHECK_EQUAL(4, recent.count());
+    CHECK_EQUAL(27500, recent.mean());
+    CHECK_EQUAL(1666667, recent.variance());
+}
+
+int main() {
+    testLongRunStep();
+    testSlowRamp();
+    testNegativeValues();
+    testHistory();
+    return TEST_RESULT();
+}
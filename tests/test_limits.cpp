@@ -0,0 +1,145 @@
+/**
+ *   @file test_limits.cpp
+ *
+ *  Bank limit writes: one Group Command per changed limit, PAGE only where
+ *  needed, a batched read-back per supply and no traffic when nothing changes.
+ */
+
+#include "RACM600Sim.h"
+#include "RACM600Bank.h"
+#include "RACM600Test.h"
+
+#define SUPPLIES 16
+
+typedef RACM600Bank<SUPPLIES, RACM600SimBus> Bank;
+
+struct Rig {
+    RACM600Simulator sim;
+    RACM600SimDevice supplies[SUPPLIES];
+    uint8_t addresses[SUPPLIES];
+    Bank bank;
+
+    Rig(uint8_t count = SUPPLIES) : sim(400000), bank(addressList(), count, 1000, RACM600SimBus(sim)) {
+        for (uint8_t i = 0; i < SUPPLIES; i++) {
+            supplies[i] = RACM600SimDevice(addresses[i]);
+            sim.attach(supplies[i]);
+        }
+    }
+
+    const uint8_t* addressList() {
+        for (uint8_t i = 0; i < SUPPLIES; i++) addresses[i] = 0x20 + i;
+        return addresses;
+    }
+
+    uint32_t writes() const {
+        uint32_t total = 0;
+        for (uint8_t i = 0; i < SUPPLIES; i++) total += supplies[i].writes();
+        return total;
+    }
+};
+
+static bool holds(const RACM600SimDevice& supply, const RACM600Limits& limits, uint8_t page) {
+    uint8_t mode = supply.reg(RACM600_VOUT_MODE, page);
+    return RACM600Base::decodeLimit(RACM600_LIMIT_VOUT_OV_FAULT, supply.reg(RACM600_VOUT_OV_FAULT_LIMIT, page), mode) == limits.voutOvFault_mV
+        && RACM600Base::decodeLimit(RACM600_LIMIT_IOUT_OC_FAULT, supply.reg(RACM600_IOUT_OC_FAULT_LIMIT, page), mode) == limits.ioutOcFault_mA
+        && RACM600Base::decodeLimit(RACM600_LIMIT_IOUT_OC_WARN, supply.reg(RACM600_IOUT_OC_WARN_LIMIT, page), mode) == limits.ioutOcWarn_mA;
+}
+
+// 3 Group Commands plus 16 read-backs of 3 registers, then 1 + 16 for one change, then nothing
+static void testGroupLimits() {
+    Rig rig;
+    rig.bank.begin();
+    RACM600Limits limits = { 14000, 54000, 50000 };
+
+    uint32_t transactions = rig.sim.transactions();
+    uint32_t writes = rig.writes();
+    CHECK_EQUAL(SUPPLIES, rig.bank.setLimits(limits));
+    CHECK_EQUAL(3 + SUPPLIES * 3, rig.sim.transactions() - transactions);
+    CHECK_EQUAL(SUPPLIES * 3, rig.writes() - writes);
+    for (uint8_t i = 0; i < SUPPLIES; i++) {
+        CHECK(holds(rig.supplies[i], limits, RACM600_PAGE_MAIN));
+        CHECK_EQUAL(3, rig.bank.device(i).limitWrites());
+    }
+
+    limits.ioutOcWarn_mA = 48000;
+    uint16_t trace[512];
+    rig.sim.setTrace(trace, 512);
+    transactions = rig.sim.transactions();
+    CHECK_EQUAL(SUPPLIES, rig.bank.setLimits(limits));
+    CHECK_EQUAL(1 + SUPPLIES, rig.sim.transactions() - transactions);
+
+    // START, then address, command and value per supply, repeated STARTs between, one STOP
+    for (uint8_t i = 0; i < SUPPLIES; i++) {
+        CHECK_EQUAL(i == 0 ? RACM600_SIM_START : RACM600_SIM_RESTART, trace[i * 5]);
+        CHECK_EQUAL((0x20 + i) << 1, trace[i * 5 + 1]);
+        CHECK_EQUAL(RACM600_IOUT_OC_WARN_LIMIT, trace[i * 5 + 2]);
+    }
+    CHECK_EQUAL(RACM600_SIM_STOP, trace[SUPPLIES * 5]);
+    rig.sim.setTrace(NULL, 0);
+    CHECK(holds(rig.supplies[SUPPLIES - 1], limits, RACM600_PAGE_MAIN));
+
+    transactions = rig.sim.transactions();
+    CHECK_EQUAL(SUPPLIES, rig.bank.setLimits(limits));
+    CHECK_EQUAL(0, rig.sim.transactions() - transactions);
+}
+
+// PAGE is written once per supply for AUX, and not at all when Main already holds its limits
+static void testAuxPage() {
+    Rig rig;
+    rig.bank.begin();
+    RACM600Limits main = { 14000, 54000, 50000 };
+    RACM600Limits aux = { 6000, 3250, 2750 };   // Exact in LINEAR11
+    CHECK_EQUAL(SUPPLIES, rig.bank.setLimits(main));
+
+    uint32_t pageWrites = rig.bank.device(0).pageWrites();
+    CHECK_EQUAL(SUPPLIES, rig.bank.setLimits(aux, RACM600_PAGE_AUX));
+    CHECK_EQUAL(pageWrites + 1, rig.bank.device(0).pageWrites());
+    for (uint8_t i = 0; i < SUPPLIES; i++) {
+        CHECK(holds(rig.supplies[i], aux, RACM600_PAGE_AUX));
+        CHECK(holds(rig.supplies[i], main, RACM600_PAGE_MAIN));
+        CHECK_EQUAL(RACM600_PAGE_AUX, rig.supplies[i].page());
+    }
+
+    uint32_t transactions = rig.sim.transactions();
+    CHECK_EQUAL(SUPPLIES, rig.bank.setLimits(main));
+    CHECK_EQUAL(0, rig.sim.transactions() - transactions);
+}
+
+// A supply with another VOUT_MODE gets its own VOUT_OV_FAULT_LIMIT Group Command
+static void testMixedVoutMode() {
+    Rig rig;
+    rig.supplies[5].setReg(RACM600_VOUT_MODE, 0x16);   // Exponent -10
+    rig.bank.begin();
+    RACM600Limits limits = { 14000, 54000, 50000 };
+
+    uint32_t transactions = rig.sim.transactions();
+    CHECK_EQUAL(SUPPLIES, rig.bank.setLimits(limits));
+    CHECK_EQUAL(4 + SUPPLIES * 3, rig.sim.transactions() - transactions);
+    CHECK_EQUAL(14000 * 1024 / 1000, rig.supplies[5].reg(RACM600_VOUT_OV_FAULT_LIMIT));
+    CHECK_EQUAL(14000 * 512 / 1000, rig.supplies[4].reg(RACM600_VOUT_OV_FAULT_LIMIT));
+    for (uint8_t i = 0; i < SUPPLIES; i++) {
+        CHECK(holds(rig.supplies[i], limits, RACM600_PAGE_MAIN));
+    }
+}
+
+// A missing supply is left out and not counted, the others are still set
+static void testMissingSupply() {
+    Rig rig;
+    uint8_t addresses[3] = { 0x20, 0x3F, 0x21 };
+    Bank bank(addresses, 3, 1000, RACM600SimBus(rig.sim));
+    bank.begin();
+    RACM600Limits limits = { 14000, 54000, 50000 };
+
+    CHECK_EQUAL(2, bank.setLimits(limits));
+    CHECK(holds(rig.supplies[0], limits, RACM600_PAGE_MAIN));
+    CHECK(holds(rig.supplies[1], limits, RACM600_PAGE_MAIN));
+    CHECK_EQUAL(2, bank.setLimits(limits));
+}
+
+int main() {
+    testGroupLimits();
+    testAuxPage();
+    testMixedVoutMode();
+    testMissingSupply();
+    return TEST_RESULT();
+}
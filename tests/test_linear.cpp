@@ -0,0 +1,104 @@
+/**
+ *   @file test_linear.cpp
+ *
+ *  RACM600Linear.h integer decoders against an exact double precision
+ *  reference: rounding of halves, extreme exponents, negative mantissas and
+ *  saturation.
+ */
+
+#include <math.h>
+#include "RACM600Sim.h"
+#include "RACM600Test.h"
+
+// value rounded to the nearest integer, halves away from zero, saturated to int32_t
+static long long reference(double value) {
+    double rounded = value < 0 ? -floor(-value + 0.5) : floor(value + 0.5);
+    if (rounded > 2147483647.0) return 2147483647LL;
+    if (rounded < -2147483648.0) return -2147483648LL;
+    return (long long)rounded;
+}
+
+static double linear11(uint16_t raw) {
+    return RACM600Linear::mantissa11(raw) * ldexp(1.0, RACM600Linear::exponent11(raw));
+}
+
+// Every LINEAR11 word, in the milli and centi units the driver uses
+static void testLinear11Exhaustive() {
+    const int32_t units[] = { 1000, 100, 1 };
+    for (uint8_t u = 0; u < 3; u++) {
+        uint32_t mismatches = 0;
+        for (uint32_t raw = 0; raw <= 0xFFFF; raw++) {
+            long long expected = reference(linear11(raw) * units[u]);
+            long long actual = RACM600Linear::decodeLinear11Scaled(raw, units[u]);
+            if (expected != actual && mismatches++ == 0) CHECK_EQUAL(expected, actual);
+        }
+        CHECK_EQUAL(0, mismatches);
+    }
+}
+
+// Large positive exponents saturate instead of wrapping
+static void testLinear11Saturates() {
+    CHECK_EQUAL(2147483647LL, RACM600Linear::decodeLinear11Scaled(0x7BFF, 1000));    // 1023 * 2^15
+    CHECK_EQUAL(-2147483648LL, RACM600Linear::decodeLinear11Scaled(0x7C00, 1000));   // -1024 * 2^15
+    CHECK_EQUAL(1023LL * 32768, RACM600Linear::decodeLinear11Scaled(0x7BFF, 1));
+    CHECK_EQUAL(2147483647LL, RACM600Linear::decodeLinear11Scaled(0x7BFF, 2147483647));
+}
+
+// Every LINEAR16 word under every VOUT_MODE exponent
+static void testLinear16Exhaustive() {
+    uint32_t mismatches = 0;
+    for (uint8_t field = 0; field < 32; field++) {
+        uint8_t voutMode = field;          // LINEAR16 mode, exponent field only
+        double scale = ldexp(1.0, RACM600Linear::voutExponent(voutMode));
+        for (uint32_t raw = 0; raw <= 0xFFFF; raw++) {
+            long long expected = reference(raw * scale * 1000);
+            long long actual = RACM600Linear::decodeLinear16Scaled(raw, voutMode, 1000);
+            if (expected != actual && mismatches++ == 0) CHECK_EQUAL(expected, actual);
+        }
+    }
+    CHECK_EQUAL(0, mismatches);
+}
+
+// The ends of both exponent ranges, and negative mantissas from -1 to -1024
+static void testExtremes() {
+    CHECK_EQUAL(2147483647LL, RACM600Linear::decodeLinear16Scaled(0xFFFF, 0x0F, 1000));  // 65535 * 2^15
+    CHECK_EQUAL(65535LL * 32768, RACM600Linear::decodeLinear16Scaled(0xFFFF, 0x0F, 1));
+    CHECK_EQUAL(1000, RACM600Linear::decodeLinear16Scaled(0xFFFF, 0x10, 1000));          // 65535 * 2^-16
+    CHECK_EQUAL(0, RACM600Linear::decodeLinear16Scaled(0x0001, 0x10, 1000));             // 0.015 mV
+    CHECK_EQUAL(2147483647LL, RACM600Linear::decodeLinear16Scaled(0xFFFF, 0x17, 2147483647));
+    CHECK_EQUAL(-9, RACM600Linear::voutExponent(0xF7));                                 // Mode bits ignored
+
+    CHECK_EQUAL(-1024000, RACM600Linear::decodeLinear11Scaled(0x0400, 1000));             // -1024 * 2^0
+    CHECK_EQUAL(-16, RACM600Linear::decodeLinear11Scaled(0x8400, 1000));                  // -1024 * 2^-16 = -15.6
+    CHECK_EQUAL(0, RACM600Linear::decodeLinear11Scaled(0x87FF, 1000));                    // -1 * 2^-16
+    CHECK_EQUAL(-1, RACM600Linear::decodeLinear11Scaled(0xFFFF, 1));                      // -1 * 2^-1 = -0.5
+    CHECK_EQUAL(-1000, RACM600Linear::decodeLinear11Scaled(0xFFFE, 1000));                // -2 * 2^-1
+    CHECK_EQUAL(-1024LL * 16384 * 100, RACM600Linear::decodeLinear11Scaled(0x7400, 100)); // -1024 * 2^14
+}
+
+// Halves round away from zero for both signs, matching divideRounded()
+static void testRoundsHalvesAwayFromZero() {
+    CHECK_EQUAL(1, RACM600Linear::shiftRounded(1, -1));
+    CHECK_EQUAL(-1, RACM600Linear::shiftRounded(-1, -1));
+    CHECK_EQUAL(2, RACM600Linear::shiftRounded(3, -1));
+    CHECK_EQUAL(-2, RACM600Linear::shiftRounded(-3, -1));
+    CHECK_EQUAL(0, RACM600Linear::shiftRounded(-1, -2));
+    CHECK_EQUAL(1, RACM600Linear::divideRounded(1, 2, 0));
+    CHECK_EQUAL(-1, RACM600Linear::divideRounded(-1, 2, 0));
+
+    // Decoding an encoded value gives it back wherever the encoding is exact
+    const int32_t values[] = { -1500, -1, 0, 1, 250, 40000, -40000, 1023 };
+    for (uint8_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        uint16_t raw = RACM600Linear::encodeLinear11Scaled(values[i], 1000);
+        CHECK_EQUAL(values[i], RACM600Linear::decodeLinear11Scaled(raw, 1000));
+    }
+}
+
+int main() {
+    testLinear11Exhaustive();
+    testLinear11Saturates();
+    testLinear16Exhaustive();
+    testExtremes();
+    testRoundsHalvesAwayFromZero();
+    return TEST_RESULT();
+}
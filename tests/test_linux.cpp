@@ -0,0 +1,109 @@
+/**
+ *   @file test_linux.cpp
+ *
+ *  RACM600LinuxBus.h with I2C_RDWR replaced by a fake ioctl that plays each
+ *  message list against the simulator: ioctls per transfer, Group Commands,
+ *  and a failed ioctl failing only the registers it carried.
+ */
+
+#include <fcntl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+#include "RACM600Sim.h"
+#include "RACM600Test.h"
+
+static RACM600Simulator sim(400000);
+static uint8_t failIoctls = 0;
+
+// Plays the messages of one I2C_RDWR call, a STOP after the last one. Fails the call when
+// any message is not acknowledged, as the kernel does.
+static int fakeIoctl(int fd, unsigned long request, struct i2c_rdwr_ioctl_data* transfer) {
+    (void)fd;
+    if (request != I2C_RDWR) return -1;
+    if (failIoctls > 0) {
+        failIoctls--;
+        return -1;
+    }
+    for (uint32_t i = 0; i < transfer->nmsgs; i++) {
+        struct i2c_msg& message = transfer->msgs[i];
+        bool last = i + 1 == transfer->nmsgs;
+        bool acked = (message.flags & I2C_M_RD) ? sim.read(message.addr, message.buf, message.len)
+                                                : sim.write(message.addr, message.buf, message.len, last);
+        if (!acked) return -1;
+    }
+    return transfer->nmsgs;
+}
+
+#define RACM600_LINUX_IOCTL fakeIoctl
+#include "RACM600LinuxBus.h"
+
+typedef RACM600Device<RACM600LinuxBus> Device;
+
+static RACM600SimDevice first(0x27);
+static RACM600SimDevice second(0x28);
+static RACM600LinuxI2C adapter;
+
+// A register read is one ioctl, and so is a whole snapshot
+static void testIoctlsPerTransfer(Device& psu) {
+    first.setCurrent(20.0f);
+    uint32_t ioctls = adapter.ioctls();
+    CHECK_EQUAL(20000, psu.readCurrent_mA());
+    CHECK_EQUAL(1, adapter.ioctls() - ioctls);
+
+    ioctls = adapter.ioctls();
+    RACM600Snapshot snapshot;
+    CHECK(psu.readSnapshot(snapshot));
+    CHECK_EQUAL(1, adapter.ioctls() - ioctls);
+    CHECK_EQUAL(first.reg(RACM600_READ_IOUT), snapshot.raw[RACM600_CH_IOUT]);
+    CHECK_EQUAL(first.reg(RACM600_READ_VIN), snapshot.raw[RACM600_CH_VIN]);
+}
+
+// Both supplies switch in one ioctl with a single STOP
+static void testGroupCommand(Device& psu, Device& other) {
+    Device* devices[] = { &psu, &other };
+    uint32_t ioctls = adapter.ioctls();
+    CHECK(Device::groupDisableOutput(devices, 2));
+    CHECK_EQUAL(1, adapter.ioctls() - ioctls);
+    CHECK(!first.outputOn());
+    CHECK(!second.outputOn());
+    CHECK(Device::groupEnableOutput(devices, 2));
+    CHECK(first.outputOn() && second.outputOn());
+}
+
+// A failed ioctl fails the registers it carried, and with PEC on they are bus errors rather
+// than PEC mismatches
+static void testFailedIoctl(Device& psu) {
+    psu.setPec(true);
+    RACM600Stats::reset();
+    failIoctls = 1;
+    RACM600Snapshot snapshot;
+    CHECK(!psu.readSnapshot(snapshot));
+    CHECK_EQUAL(0, psu.pecErrors());
+    CHECK_EQUAL(0, snapshot.raw[RACM600_CH_VIN]);
+    CHECK_EQUAL(1, RACM600Stats::find(RACM600_READ_VIN)->errors);
+
+    CHECK(psu.readSnapshot(snapshot));
+    CHECK_EQUAL(0, psu.pecErrors());
+    CHECK_EQUAL(first.reg(RACM600_READ_VIN), snapshot.raw[RACM600_CH_VIN]);
+    CHECK_EQUAL(1, RACM600Stats::find(RACM600_READ_VIN)->errors);
+    psu.setPec(false);
+}
+
+int main() {
+    sim.attach(first);
+    sim.attach(second);
+    CHECK(adapter.open("/dev/null"));    // Any descriptor will do, the fake never uses it
+
+    Device psu(0x27, RACM600LinuxBus(adapter));
+    Device other(0x28, RACM600LinuxBus(adapter));
+    psu.begin();
+    other.begin();
+    CHECK_EQUAL(0x17, psu.voutMode());
+
+    testIoctlsPerTransfer(psu);
+    testGroupCommand(psu, other);
+    testFailedIoctl(psu);
+    adapter.close();
+    return TEST_RESULT();
+}
@@ -0,0 +1,162 @@
+/**
+ *   @file test_poll.cpp
+ *
+ *  The two phase non-blocking read engine: phase order on the wire, failures
+ *  in either phase, restarting after an error, and its timing counters.
+ */
+
+#include "RACM600Sim.h"
+#include "RACM600Test.h"
+
+#define S   RACM600_SIM_START
+#define SR  RACM600_SIM_RESTART
+#define P   RACM600_SIM_STOP
+#define NAK RACM600_SIM_NAK
+
+// Simulated bus whose next read phases are NAKed, releasing the bus as a real NAK does
+class FailingReadBus : public RACM600SimBus {
+public:
+    FailingReadBus() : _failures(0) {}
+    FailingReadBus(RACM600Simulator& sim) : RACM600SimBus(sim), _failures(0) {}
+
+    void failReads(uint8_t reads) { _failures = reads; }
+
+    bool read(uint8_t address, uint8_t* data, uint8_t length) {
+        if (_failures > 0) {
+            _failures--;
+            simulator().read(0x7F, data, length);   // Nobody answers, STOP follows
+            return false;
+        }
+        return RACM600SimBus::read(address, data, length);
+    }
+
+private:
+    uint8_t _failures;
+};
+
+typedef RACM600Device<FailingReadBus> Device;
+
+struct Rig {
+    RACM600Simulator sim;
+    RACM600SimDevice supply;
+    Device psu;
+
+    Rig() : sim(400000), supply(0x27), psu(0x27, FailingReadBus(sim)) {
+        sim.attach(supply);
+        psu.begin();
+    }
+};
+
+// Command write with the bus held, then the repeated START read and STOP, one per poll()
+static void testPhaseOrder() {
+    Rig rig;
+    rig.supply.setCurrent(20.0f);
+    uint16_t trace[32];
+    rig.sim.setTrace(trace, 32);
+
+    CHECK(rig.psu.beginRead(RACM600_READ_IOUT));
+    CHECK(!rig.psu.resultReady());
+    CHECK(!rig.psu.poll());
+    const uint16_t write[] = { S, 0x4E, RACM600_READ_IOUT };
+    CHECK_EQUAL(3, rig.sim.traceLength());
+    for (uint8_t i = 0; i < 3; i++) CHECK_EQUAL(write[i], trace[i]);
+    CHECK(!rig.psu.beginRead(RACM600_READ_VOUT));      // One read in flight at a time
+
+    CHECK(rig.psu.poll());
+    CHECK_EQUAL(SR, trace[3]);
+    CHECK_EQUAL(0x4F, trace[4]);
+    CHECK_EQUAL(P, trace[rig.sim.traceLength() - 1]);
+    CHECK_EQUAL(1, rig.sim.transactions() - 1 - 1);    // PAGE and VOUT_MODE from begin(), then this read
+
+    uint32_t length = rig.sim.traceLength();
+    CHECK(rig.psu.poll());                              // Ready stays ready with no bus traffic
+    CHECK_EQUAL(length, rig.sim.traceLength());
+
+    uint16_t raw = 0;
+    CHECK(rig.psu.readResult(raw));
+    CHECK_EQUAL(rig.supply.reg(RACM600_READ_IOUT), raw);
+    CHECK(!rig.psu.resultReady());
+    CHECK(!rig.psu.readResult(raw));                    // Collected once
+}
+
+// A NAKed command phase completes at once, a NAKed read phase after both, and either way
+// the next read starts cleanly
+static void testFailures() {
+    Rig rig;
+    uint16_t raw = 0xBEEF;
+
+    RACM600Simulator empty(400000);
+    Device ghost(0x27, FailingReadBus(empty));
+    CHECK(ghost.beginRead(RACM600_READ_VIN));           // Not paged, no PAGE write first
+    CHECK(ghost.poll());
+    CHECK(!ghost.readResult(raw));
+    CHECK_EQUAL(0xBEEF, raw);
+
+    rig.psu.bus().failReads(1);
+    CHECK(rig.psu.beginRead(RACM600_READ_VIN));
+    CHECK(!rig.psu.poll());
+    CHECK(rig.psu.poll());
+    CHECK(!rig.psu.readResult(raw));
+    CHECK_EQUAL(0xBEEF, raw);
+
+    CHECK(rig.psu.beginRead(RACM600_READ_VIN));
+    CHECK(!rig.psu.poll());
+    CHECK(rig.psu.poll());
+    CHECK(rig.psu.readResult(raw));
+    CHECK_EQUAL(rig.supply.reg(RACM600_READ_VIN), raw);
+
+    // A new read may also replace a result nobody collected
+    CHECK(rig.psu.beginRead(RACM600_READ_VIN));
+    CHECK(!rig.psu.poll());
+    CHECK(rig.psu.poll());
+    CHECK(rig.psu.beginRead(RACM600_READ_VCAP));
+    CHECK(!rig.psu.poll());
+    CHECK(rig.psu.poll());
+    CHECK(rig.psu.readResult(raw));
+    CHECK_EQUAL(rig.supply.reg(RACM600_READ_VCAP), raw);
+}
+
+// A paged register read after an AUX read selects Page 0 within the first phase
+static void testPagedRead() {
+    Rig rig;
+    rig.supply.setCurrent(2.0f, RACM600_PAGE_AUX);
+    RACM600AuxSnapshot aux;
+    CHECK(rig.psu.readAuxSnapshot(aux));
+
+    uint16_t raw = 0;
+    CHECK(rig.psu.beginRead(RACM600_READ_IOUT));
+    CHECK(!rig.psu.poll());
+    CHECK_EQUAL(RACM600_PAGE_MAIN, rig.supply.page());
+    CHECK(rig.psu.poll());
+    CHECK(rig.psu.readResult(raw));
+    CHECK_EQUAL(rig.supply.reg(RACM600_READ_IOUT, RACM600_PAGE_MAIN), raw);
+}
+
+// Latency spans both phases and the work between them, a step only one phase
+static void testTiming() {
+    Rig rig;
+    CHECK(rig.psu.beginRead(RACM600_READ_VIN));
+    uint32_t start = rig.sim.micros();
+    CHECK(!rig.psu.poll());
+    uint32_t firstStep = rig.sim.micros() - start;
+    rig.sim.advance(500);                               // Other work between phases
+    uint32_t secondStart = rig.sim.micros();
+    CHECK(rig.psu.poll());
+    uint32_t secondStep = rig.sim.micros() - secondStart;
+
+    CHECK_EQUAL(rig.sim.micros() - start, rig.psu.lastTransactionMicros());
+    CHECK_EQUAL(firstStep > secondStep ? firstStep : secondStep, rig.psu.maxPollStepMicros());
+    CHECK(rig.psu.maxPollStepMicros() < rig.psu.lastTransactionMicros() - 500);
+
+    rig.psu.resetPollTiming();
+    CHECK_EQUAL(0, rig.psu.lastTransactionMicros());
+    CHECK_EQUAL(0, rig.psu.maxPollStepMicros());
+}
+
+int main() {
+    testPhaseOrder();
+    testFailures();
+    testPagedRead();
+    testTiming();
+    return TEST_RESULT();
+}
@@ -0,0 +1,89 @@
+/**
+ *   @file test_ratings.cpp
+ *
+ *  MFR_* ratings: loaded on first use rather than by begin(), and per mille
+ *  reciprocals that read exactly 1000 at every rating.
+ */
+
+#include "RACM600Sim.h"
+#include "RACM600Test.h"
+
+typedef RACM600Device<RACM600SimBus> Device;
+
+// begin() leaves the ratings alone, the first ratings() call reads them once
+static void testRatingsLoadOnFirstUse() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    Device psu(0x27, RACM600SimBus(sim));
+
+    psu.begin();
+    uint32_t afterBegin = sim.transactions();
+    CHECK(!psu.ratingsValid());
+    CHECK(afterBegin <= 2);             // PAGE and VOUT_MODE only
+
+    const RACM600Ratings& rated = psu.ratings();
+    CHECK(psu.ratingsValid());
+    CHECK(sim.transactions() > afterBegin);
+    CHECK_EQUAL(50000, rated.ioutMax_mA);
+    CHECK_EQUAL(600000, rated.poutMax_mW);
+    CHECK_EQUAL(680000, rated.pinMax_mW);
+    CHECK_EQUAL(12600, rated.voutMax_mV);
+
+    uint32_t loaded = sim.transactions();
+    psu.ratings();
+    CHECK_EQUAL(loaded, sim.transactions());
+
+    CHECK_EQUAL(1000, rated.pinPerMille(rated.pinMax_mW));
+    CHECK_EQUAL(1000, rated.poutPerMille(rated.poutMax_mW));
+    CHECK_EQUAL(1000, rated.ioutPerMille(rated.ioutMax_mA));
+    CHECK_EQUAL(1000, rated.iinPerMille(rated.iinMax_mA));
+    CHECK_EQUAL(750, rated.ioutPerMille(37500));
+}
+
+// A supply that cannot be read leaves the ratings zero and is asked again next time
+static void testRatingsRetry() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    Device psu(0x27, RACM600SimBus(sim));
+    psu.begin();
+    CHECK_EQUAL(0, psu.ratings().ioutMax_mA);
+    CHECK(!psu.ratingsValid());
+
+    sim.attach(supply);
+    CHECK_EQUAL(50000, psu.ratings().ioutMax_mA);
+    CHECK(psu.ratingsValid());
+}
+
+// value * 1000 / maximum, rounded half away from zero
+static int32_t exactPerMille(int32_t value, int32_t maximum) {
+    int64_t scaled = (int64_t)value * 1000;
+    int64_t half = maximum / 2;
+    return (int32_t)((scaled + (scaled < 0 ? -half : half)) / maximum);
+}
+
+// The reciprocal matches exact division across the whole range of maxima
+static void testReciprocal() {
+    const int32_t maxima[] = { 1, 3, 7, 999, 1000, 1001, 7500, 50000, 600000, 680000, 1048575, 0x7FFFFFFF };
+    for (uint8_t i = 0; i < sizeof(maxima) / sizeof(maxima[0]); i++) {
+        int32_t maximum = maxima[i];
+        RACM600Reciprocal reciprocal = RACM600Reciprocal::forMaximum(maximum);
+        CHECK_EQUAL(1000, reciprocal.perMille(maximum));
+        CHECK_EQUAL(0, reciprocal.perMille(0));
+        const int32_t values[] = { maximum / 2, maximum / 3, maximum / 7, maximum / 1000, -maximum / 4 };
+        for (uint8_t j = 0; j < sizeof(values) / sizeof(values[0]); j++) {
+            CHECK_EQUAL(exactPerMille(values[j], maximum), reciprocal.perMille(values[j]));
+        }
+    }
+
+    RACM600Reciprocal none = RACM600Reciprocal::forMaximum(0);
+    CHECK_EQUAL(0, none.perMille(12345));
+    CHECK_EQUAL(0, RACM600Reciprocal::forMaximum(-5).perMille(12345));
+}
+
+int main() {
+    testRatingsLoadOnFirstUse();
+    testRatingsRetry();
+    testReciprocal();
+    return TEST_RESULT();
+}
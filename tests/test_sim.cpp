@@ -0,0 +1,126 @@
+/**
+ *   @file test_sim.cpp
+ *
+ *  RACM600Sim.h: the simulated register map, bus timing, NAK injection and
+ *  PMBus write execution at STOP.
+ */
+
+#include "RACM600Sim.h"
+#include "RACM600Test.h"
+
+typedef RACM600Device<RACM600SimBus> Device;
+
+static void testRegisterMap() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    Device psu(0x27, RACM600SimBus(sim));
+    psu.begin();
+
+    CHECK_EQUAL(0x17, psu.voutMode());
+    CHECK_EQUAL(12000, psu.readVoltage_mV());
+    supply.setCurrent(20.0f);
+    CHECK_EQUAL(20000, psu.readCurrent_mA());
+    CHECK_EQUAL(240000, psu.readPower_mW());
+    CHECK_EQUAL(2500, psu.readAmbientTemperature_cC());
+
+    uint16_t raw;
+    CHECK_EQUAL(RACM600_OK, psu.tryReadWord(RACM600_READ_VOUT, RACM600_PAGE_AUX, raw));
+    CHECK_EQUAL(5000, RACM600Linear::decodeLinear16Scaled(raw, 0x17, 1000));
+
+    CHECK_EQUAL(RACM600_OK, psu.tryReadWord(RACM600_MFR_POUT_MAX, raw));
+    CHECK_EQUAL(600000, RACM600Linear::decodeLinear11Scaled(raw, 1000));
+}
+
+static void testLimitsLatchFaults() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    Device psu(0x27, RACM600SimBus(sim));
+    psu.begin();
+
+    CHECK(!sim.alertAsserted());
+    supply.setCurrent(53.0f);       // Past IOUT_OC_WARN_LIMIT, short of the fault limit
+    CHECK(sim.alertAsserted());
+    RACM600FaultReport report;
+    psu.readFaults(report);
+    CHECK(report.statusWord & 0x4000);
+    CHECK_EQUAL(0x20, report.detail[RACM600_DETAIL_IOUT]);
+
+    CHECK_EQUAL(0x27, psu.readAlertResponse());
+    CHECK(!sim.alertAsserted());
+
+    supply.setCurrent(10.0f);
+    psu.clearFaults();
+    psu.readFaults(report);
+    CHECK_EQUAL(0, report.statusWord);
+}
+
+// One word read is START, address, command, repeated START, address, two data bytes and STOP
+static void testTiming() {
+    const uint32_t clocks[] = { 100000, 400000 };
+    for (uint8_t i = 0; i < 2; i++) {
+        RACM600Simulator sim(clocks[i]);
+        RACM600SimDevice supply(0x27);
+        sim.attach(supply);
+        Device psu(0x27, RACM600SimBus(sim));
+
+        uint32_t start = sim.micros();
+        uint16_t raw;
+        CHECK_EQUAL(RACM600_OK, psu.tryReadWord(RACM600_READ_VIN, raw));
+        CHECK_EQUAL(48 * 1000000UL / clocks[i], sim.micros() - start);
+        CHECK_EQUAL(1, sim.transactions());
+        CHECK_EQUAL(5, sim.bytes());
+    }
+}
+
+// A write takes effect at the STOP ending its transaction, not when its bytes arrive
+static void testWriteExecutesAtStop() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+
+    uint8_t off[] = { RACM600_OPERATION, 0x00 };
+    CHECK(sim.write(0x27, off, sizeof(off), false));
+    CHECK(supply.outputOn());
+    CHECK(supply.writePending());
+
+    uint8_t command = RACM600_READ_VIN;     // Any last segment, its STOP ends the transaction
+    CHECK(sim.write(0x27, &command, 1, true));
+    CHECK(!supply.outputOn());
+    CHECK(!supply.writePending());
+    CHECK_EQUAL(1, supply.writes());
+    CHECK_EQUAL(1, sim.transactions());
+}
+
+// An injected NAK fails the transfer and ends the transaction with a STOP
+static void testNakInjection() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    Device psu(0x27, RACM600SimBus(sim));
+
+    sim.setNakRate(1.0f);
+    uint16_t raw;
+    CHECK_EQUAL(RACM600_BUS_ERROR, psu.tryReadWord(RACM600_READ_VIN, raw));
+    CHECK_EQUAL(1, sim.naks());
+    sim.setNakRate(0.0f);
+    CHECK_EQUAL(RACM600_OK, psu.tryReadWord(RACM600_READ_VIN, raw));
+    CHECK_EQUAL(2, sim.transactions());
+
+    sim.setNakRate(0.1f);
+    uint32_t failures = 0;
+    for (uint16_t i = 0; i < 1000; i++) {
+        if (psu.tryReadWord(RACM600_READ_VIN, raw) != RACM600_OK) failures++;
+    }
+    CHECK(failures > 50 && failures < 300);     // Up to two chances to NAK per read
+}
+
+int main() {
+    testRegisterMap();
+    testLimitsLatchFaults();
+    testTiming();
+    testWriteExecutesAtStop();
+    testNakInjection();
+    return TEST_RESULT();
+}
@@ -0,0 +1,167 @@
+/**
+ *   @file test_snapshot.cpp
+ *
+ *  Snapshot and other batched reads: the VOUT_MODE each snapshot carries,
+ *  failures that leave it unknown, and failed registers retried per the
+ *  retry policy.
+ */
+
+#include <string.h>
+#include "RACM600Sim.h"
+#include "RACM600Test.h"
+
+// Simulated bus that fails the next reads of one command
+class FlakyBus : public RACM600SimBus {
+public:
+    FlakyBus() : _command(0), _failures(0) {}
+    FlakyBus(RACM600Simulator& sim) : RACM600SimBus(sim), _command(0), _failures(0) {}
+
+    void fail(uint8_t command, uint8_t reads) {
+        _command = command;
+        _failures = reads;
+    }
+
+    bool writeRead(uint8_t address, const uint8_t* out, uint8_t outLength, uint8_t* in, uint8_t inLength) {
+        if (outLength == 1 && out[0] == _command && _failures > 0) {
+            _failures--;
+            return false;
+        }
+        return RACM600SimBus::writeRead(address, out, outLength, in, inLength);
+    }
+
+    // Batched reads go through writeRead() above, so they fail the same way
+    bool readRegisters(uint8_t address, const uint8_t* commands, uint8_t count, uint8_t* data, uint8_t length, bool* ok) {
+        bool complete = true;
+        for (uint8_t i = 0; i < count; i++, data += length) {
+            ok[i] = writeRead(address, &commands[i], 1, data, length);
+            if (!ok[i]) {
+                memset(data, 0, length);
+                complete = false;
+            }
+        }
+        return complete;
+    }
+
+private:
+    uint8_t _command;
+    uint8_t _failures;
+};
+
+typedef RACM600Device<FlakyBus> Device;
+
+// A VOUT_MODE that begin() could not read is read by the first snapshot
+static void testSnapshotReadsVoutMode() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    supply.setReg(RACM600_VOUT_MODE, 0x16);
+    Device psu(0x27, FlakyBus(sim));
+    psu.begin();                                // Nobody on the bus yet
+    sim.attach(supply);
+
+    RACM600Snapshot snapshot;
+    CHECK(psu.readSnapshot(snapshot));
+    CHECK_EQUAL(0x16, snapshot.voutMode);
+    CHECK_EQUAL(supply.reg(RACM600_READ_VOUT), snapshot.raw[0]);
+}
+
+// A snapshot whose VOUT_MODE cannot be read is incomplete even when every channel was read
+static void testSnapshotFailsWithoutVoutMode() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    Device psu(0x27, FlakyBus(sim));
+    psu.begin();
+    sim.attach(supply);
+
+    psu.bus().fail(RACM600_VOUT_MODE, 1);
+    RACM600Snapshot snapshot;
+    CHECK(!psu.readSnapshot(snapshot));
+    CHECK_EQUAL(supply.reg(RACM600_READ_IOUT), snapshot.raw[1]);
+
+    CHECK(psu.readSnapshot(snapshot));          // Read again on the next snapshot
+    CHECK_EQUAL(0x17, snapshot.voutMode);
+}
+
+// Likewise for the AUX VOUT_MODE and the AUX snapshot
+static void testAuxSnapshotFailsWithoutVoutMode() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    supply.setReg(RACM600_VOUT_MODE, 0x16, RACM600_PAGE_AUX);
+    sim.attach(supply);
+    Device psu(0x27, FlakyBus(sim));
+    psu.begin();
+
+    psu.bus().fail(RACM600_VOUT_MODE, 1);
+    RACM600AuxSnapshot aux;
+    CHECK(!psu.readAuxSnapshot(aux));
+    CHECK_EQUAL(supply.reg(RACM600_READ_IOUT, RACM600_PAGE_AUX), aux.raw[RACM600_AUX_IOUT]);
+
+    CHECK(psu.readAuxSnapshot(aux));
+    CHECK_EQUAL(0x16, aux.voutMode);
+    CHECK_EQUAL(0x16, psu.voutMode(RACM600_PAGE_AUX));
+}
+
+// A register that fails in a batch is retried on its own, with the policy's backoff
+static void testBatchRetries() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    Device psu(0x27, FlakyBus(sim));
+    psu.begin();
+    supply.setCurrent(20.0f);
+    RACM600Snapshot snapshot;
+
+    psu.bus().fail(RACM600_READ_IOUT, 1);
+    CHECK(!psu.readSnapshot(snapshot));         // No retries by default
+    CHECK_EQUAL(0, snapshot.raw[RACM600_CH_IOUT]);
+    CHECK_EQUAL(0, psu.retries());
+
+    CHECK(psu.readSnapshot(snapshot));
+    uint32_t start = sim.micros();
+    CHECK(psu.readSnapshot(snapshot));
+    uint32_t clean = sim.micros() - start;
+
+    psu.setRetryPolicy(3, 100);
+    psu.bus().fail(RACM600_READ_IOUT, 2);
+    start = sim.micros();
+    CHECK(psu.readSnapshot(snapshot));
+    CHECK_EQUAL(supply.reg(RACM600_READ_IOUT), snapshot.raw[RACM600_CH_IOUT]);
+    CHECK_EQUAL(2, psu.retries());
+    CHECK(sim.micros() - start >= clean + 100 + 200);
+
+    psu.bus().fail(RACM600_READ_IOUT, 4);
+    CHECK(!psu.readSnapshot(snapshot));         // Out of retries
+    CHECK_EQUAL(0, snapshot.raw[RACM600_CH_IOUT]);
+    CHECK_EQUAL(5, psu.retries());
+
+    psu.bus().fail(RACM600_MFR_VIN_MIN, 1);
+    CHECK(psu.readRatings());
+    CHECK_EQUAL(6, psu.retries());
+}
+
+// The same at a 50% NAK rate: every register gets its own retries
+static void testBatchRetriesUnderNaks() {
+    RACM600Simulator sim(400000);
+    RACM600SimDevice supply(0x27);
+    sim.attach(supply);
+    Device psu(0x27, FlakyBus(sim));
+    psu.begin();
+    psu.setRetryPolicy(10, 10);
+    sim.setNakRate(0.5f);
+
+    uint8_t complete = 0;
+    for (uint8_t i = 0; i < 100; i++) {
+        RACM600Snapshot snapshot;
+        if (psu.readSnapshot(snapshot)) complete++;
+    }
+    CHECK(complete > 30);
+    CHECK(psu.retries() > 900);
+}
+
+int main() {
+    testSnapshotReadsVoutMode();
+    testSnapshotFailsWithoutVoutMode();
+    testAuxSnapshotFailsWithoutVoutMode();
+    testBatchRetries();
+    testBatchRetriesUnderNaks();
+    return TEST_RESULT();
+}
@@ -0,0 +1,201 @@
+/**
+ *   @file test_stats.cpp
+ *
+ *  RACM600Stats: the counters themselves, then the transactions, errors, PEC
+ *  mismatches and retries the driver books for single and batched reads.
+ */
+
+#include <string.h>
+#include "RACM600Sim.h"
+#include "RACM600Test.h"
+
+// Simulated bus that flips a data bit in the next reads of one command, so its PEC mismatches,
+// or drops them from a batch as if NAKed
+class CorruptingBus : public RACM600SimBus {
+public:
+    CorruptingBus() : _command(0), _corruptions(0), _drop(false) {}
+    CorruptingBus(RACM600Simulator& sim) : RACM600SimBus(sim), _command(0), _corruptions(0), _drop(false) {}
+
+    void corrupt(uint8_t command, uint8_t reads, bool drop = false) {
+        _command = command;
+        _corruptions = reads;
+        _drop = drop;
+    }
+
+    bool writeRead(uint8_t address, const uint8_t* out, uint8_t outLength, uint8_t* in, uint8_t inLength) {
+        bool ok = RACM600SimBus::writeRead(address, out, outLength, in, inLength);
+        if (ok && outLength == 1) damage(out[0], in);
+        return ok;
+    }
+
+    bool readRegisters(uint8_t address, const uint8_t* commands, uint8_t count, uint8_t* data, uint8_t length, bool* ok) {
+        bool complete = RACM600SimBus::readRegisters(address, commands, count, data, length, ok);
+        for (uint8_t i = 0; i < count; i++) {
+            if (ok[i] && damage(commands[i], &data[i * length]) && _drop) {
+                memset(&data[i * length], 0, length);
+                ok[i] = false;
+                complete = false;
+            }
+        }
+        return complete;
+    }
+
+private:
+    bool damage(uint8_t command, uint8_t* data) {
+        if (command != _command || _corruptions == 0) {
+            return false;
+        }
+        _corruptions--;
+        data[0] ^= 0x01;
+        return true;
+    }
+
+    uint8_t _command;
+    uint8_t _corruptions;
+    bool _drop;
+};
+
+typedef RACM600Device<CorruptingBus> Device;
+
+struct Rig {
+    RACM600Simulator sim;
+    RACM600SimDevice supply;
+    Device psu;
+
+    Rig() : sim(400000), supply(0x27), psu(0x27, CorruptingBus(sim)) {
+        sim.attach(supply);
+        psu.begin();
+        RACM600Stats::reset();
+    }
+};
+
+static const RACM600CommandStats& stats(uint8_t cmd) {
+    static RACM600CommandStats none;
+    const RACM600CommandStats* found = RACM600Stats::find(cmd);
+    return found ? *found : none;
+}
+
+// Counters, latency buckets, slot overflow and saturation, straight through record()
+static void testCounters() {
+    RACM600Stats::reset();
+    RACM600Stats::record(0x8C, 50, 5, true);
+    RACM600Stats::record(0x8C, 64, 5, false);
+    RACM600Stats::record(0x8C, 5000, 6, true);
+    CHECK_EQUAL(1, RACM600Stats::size());
+    CHECK_EQUAL(3, stats(0x8C).transactions);
+    CHECK_EQUAL(1, stats(0x8C).errors);
+    CHECK_EQUAL(16, stats(0x8C).bytes);
+    CHECK_EQUAL(1, stats(0x8C).latency[0]);
+    CHECK_EQUAL(1, stats(0x8C).latency[1]);
+    CHECK_EQUAL(1, stats(0x8C).latency[RACM600_STATS_BUCKETS - 1]);
+    CHECK_EQUAL(0, RACM600Stats::bucket(63));
+    CHECK_EQUAL(2, RACM600Stats::bucket(128));
+    CHECK_EQUAL(6, RACM600Stats::bucket(4095));
+
+    for (uint8_t cmd = 0; cmd < RACM600_STATS_SLOTS + 2; cmd++) {
+        RACM600Stats::record(cmd, 10, 1, true);
+    }
+    CHECK_EQUAL(RACM600_STATS_SLOTS, RACM600Stats::size());
+    CHECK_EQUAL(3, RACM600Stats::overflow());   // 0x8C took the first slot
+
+    RACM600Stats::reset();
+    for (uint32_t i = 0; i < 0x10001; i++) {
+        RACM600Stats::record(0x01, 10, 1, false);
+    }
+    CHECK_EQUAL(0xFFFF, stats(0x01).errors);
+    CHECK_EQUAL(0xFFFF, stats(0x01).latency[0]);
+    CHECK_EQUAL(0x10001, stats(0x01).transactions);
+
+    uint8_t buffer[RACM600_STATS_RECORD_SIZE + 4];
+    CHECK_EQUAL(RACM600_STATS_RECORD_SIZE, RACM600Stats::serialize(buffer, sizeof(buffer)));
+    CHECK_EQUAL(0x01, buffer[0]);
+    CHECK_EQUAL(0, RACM600Stats::serialize(buffer, RACM600_STATS_RECORD_SIZE - 1));
+}
+
+// Registers that read 0 are successes, in single reads and in batches where another
+// register failed
+static void testZeroIsNotAnError() {
+    Rig rig;
+    CHECK_EQUAL(0, rig.supply.reg(RACM600_STATUS_WORD));
+    uint16_t raw;
+    CHECK_EQUAL(RACM600_OK, rig.psu.tryReadWord(RACM600_STATUS_WORD, raw));
+    rig.psu.bus().corrupt(RACM600_READ_VIN, 1, true);
+    RACM600Snapshot snapshot;
+    CHECK(!rig.psu.readSnapshot(snapshot));
+    CHECK_EQUAL(0, snapshot.raw[RACM600_CH_STATUS_WORD]);
+    CHECK_EQUAL(2, stats(RACM600_STATUS_WORD).transactions);
+    CHECK_EQUAL(0, stats(RACM600_STATUS_WORD).errors);
+    CHECK_EQUAL(1, stats(RACM600_READ_VIN).errors);
+    CHECK_EQUAL(0, stats(RACM600_READ_IOUT).errors);
+}
+
+// A NAK is one error and no PEC error, in single reads and in batches
+static void testNakErrors() {
+    Rig rig;
+    rig.psu.setPec(true);
+    rig.sim.setNakRate(1.0f);
+    uint16_t raw;
+    CHECK_EQUAL(RACM600_BUS_ERROR, rig.psu.tryReadWord(RACM600_READ_VIN, raw));
+    RACM600Snapshot snapshot;
+    CHECK(!rig.psu.readSnapshot(snapshot));
+    rig.sim.setNakRate(0.0f);
+
+    CHECK_EQUAL(2, stats(RACM600_READ_VIN).transactions);
+    CHECK_EQUAL(2, stats(RACM600_READ_VIN).errors);
+    CHECK_EQUAL(1, stats(RACM600_READ_VOUT).errors);
+    CHECK_EQUAL(0, rig.psu.pecErrors());
+}
+
+// A corrupted word is one error and one PEC error, in single reads and in batches
+static void testPecErrors() {
+    Rig rig;
+    rig.psu.setPec(true);
+    uint16_t raw = 0x1234;
+    rig.psu.bus().corrupt(RACM600_READ_VIN, 1);
+    CHECK_EQUAL(RACM600_PEC_ERROR, rig.psu.tryReadWord(RACM600_READ_VIN, raw));
+    CHECK_EQUAL(0x1234, raw);
+    CHECK_EQUAL(1, rig.psu.pecErrors());
+
+    rig.psu.bus().corrupt(RACM600_READ_VIN, 1);
+    RACM600Snapshot snapshot;
+    CHECK(!rig.psu.readSnapshot(snapshot));
+    CHECK_EQUAL(0, snapshot.raw[RACM600_CH_VIN]);
+    CHECK_EQUAL(rig.supply.reg(RACM600_READ_IOUT), snapshot.raw[RACM600_CH_IOUT]);
+    CHECK_EQUAL(2, rig.psu.pecErrors());
+    CHECK_EQUAL(2, stats(RACM600_READ_VIN).errors);
+    CHECK_EQUAL(0, stats(RACM600_READ_IOUT).errors);
+
+    CHECK(rig.psu.readSnapshot(snapshot));
+    CHECK_EQUAL(2, rig.psu.pecErrors());
+}
+
+// Every retry is a transaction of its own, booked with its own result
+static void testRetries() {
+    Rig rig;
+    rig.psu.setPec(true);
+    rig.psu.setRetryPolicy(3, 10);
+    uint16_t raw;
+    rig.psu.bus().corrupt(RACM600_READ_VIN, 2);
+    CHECK_EQUAL(RACM600_OK, rig.psu.tryReadWord(RACM600_READ_VIN, raw));
+    CHECK_EQUAL(2, rig.psu.retries());
+    CHECK_EQUAL(3, stats(RACM600_READ_VIN).transactions);
+    CHECK_EQUAL(2, stats(RACM600_READ_VIN).errors);
+    CHECK_EQUAL(2, rig.psu.pecErrors());
+
+    rig.sim.setNakRate(1.0f);
+    CHECK_EQUAL(RACM600_BUS_ERROR, rig.psu.tryReadWord(RACM600_READ_VCAP, raw));
+    rig.sim.setNakRate(0.0f);
+    CHECK_EQUAL(5, rig.psu.retries());
+    CHECK_EQUAL(4, stats(RACM600_READ_VCAP).transactions);
+    CHECK_EQUAL(4, stats(RACM600_READ_VCAP).errors);
+    CHECK_EQUAL(4 * 6, stats(RACM600_READ_VCAP).bytes);     // Address, command, address, word, PEC
+}
+
+int main() {
+    testCounters();
+    testZeroIsNotAnError();
+    testNakErrors();
+    testPecErrors();
+    testRetries();
+    return TEST_RESULT();
+}
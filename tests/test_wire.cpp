@@ -0,0 +1,72 @@
+/**
+ *   @file test_wire.cpp
+ *
+ *  The Arduino build of the library (RACM600 over RACM600WireBus and Wire)
+ *  against simulated supplies through the host Wire stand-in.
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "RACM600.h"
+#include "RACM600Sim.h"
+#include "RACM600Test.h"
+
+static RACM600Simulator sim(100000);
+static RACM600SimWire simWire(sim);
+static RACM600SimDevice supply(RACM600_DEFAULT_ADDR);
+
+static void testReaders(RACM600& psu) {
+    CHECK_EQUAL(12000, psu.readVoltage_mV());
+    CHECK(psu.readVoltage() > 11.99f && psu.readVoltage() < 12.01f);
+    supply.setCurrent(25.0f);
+    CHECK_EQUAL(25000, psu.readCurrent_mA());
+    CHECK_EQUAL(3000, psu.readACINPUTTemperature_cC());
+
+    RACM600Snapshot snapshot;
+    CHECK(psu.readSnapshot(snapshot));
+    CHECK_EQUAL(0, snapshot.raw[RACM600_CH_STATUS_WORD]);
+}
+
+static void testControl(RACM600& psu) {
+    psu.disableOutput();
+    CHECK(!supply.outputOn());
+    psu.enableOutput();
+    CHECK(supply.outputOn());
+}
+
+// STATUS_WORD and the detail register behind it, then the ARA that releases SMBALERT#
+static void testFaults(RACM600& psu) {
+    supply.setTemperature(1, 105.0f);
+    CHECK_EQUAL(LOW, digitalRead(2));
+    RACM600FaultReport report;
+    CHECK(psu.readFaults(report) & 0x0004);
+    CHECK_EQUAL(0x40, report.detail[RACM600_DETAIL_TEMPERATURE]);
+    CHECK_EQUAL(RACM600_DEFAULT_ADDR, psu.readAlertResponse());
+    CHECK_EQUAL(HIGH, digitalRead(2));
+    supply.setTemperature(1, 25.0f);
+    psu.clearFaults();
+}
+
+static void testPec(RACM600& psu) {
+    psu.setPec(true);
+    CHECK_EQUAL(12000, psu.readVoltage_mV());
+    CHECK_EQUAL(0, psu.pecErrors());
+    psu.setPec(false);
+}
+
+int main() {
+    sim.attach(supply);
+    Wire.attach(simWire);
+
+    RACM600 psu;
+    Wire.begin();
+    psu.begin();
+
+    testReaders(psu);
+    testControl(psu);
+    testFaults(psu);
+    testPec(psu);
+    CHECK(micros() > 0);    // The Arduino clock is the simulated bus clock
+    return TEST_RESULT();
+}